@@ -9,7 +9,10 @@
 #include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <functional>
+#include <memory>
 #include "RandomPointGenerator.h"
+#include "DistanceCache.h"
 
 struct GridCell {
     int x, y;
@@ -41,16 +44,20 @@ class AStarAlgorithm {
 private:
     double gridSize; // Grid resolution in degrees
     double maxDistance; // Max distance in km for A* search
-    std::map<std::string, double> cache; // Cache for calculated routes
+    std::shared_ptr<DistanceCache> cache; // Cache for calculated routes, may be shared
     
     // Progress callback function type
     std::function<void(int, int, const std::string&)> progressCallback;
 
 public:
-    AStarAlgorithm() : gridSize(0.001), maxDistance(100.0) {} // 100m grid, 100km max
+    AStarAlgorithm()
+        : gridSize(0.001), maxDistance(100.0) // 100m grid, 100km max
+        , cache(std::make_shared<DistanceCache>()) {}
 
     /**
-     * Find shortest path using A* algorithm
+     * Find shortest path using A* algorithm, reading through the distance
+     * cache. Only distances of paths actually found are cached; the
+     * straight-line fallback is returned but never stored.
      * @param start Start point
      * @param goal Goal point
      * @return Distance in kilometers
@@ -63,9 +70,42 @@ public:
         }
 
         // Check cache first
-        std::string cacheKey = getCacheKey(start, goal);
-        if (cache.find(cacheKey) != cache.end()) {
-            return cache[cacheKey];
+        double cached;
+        if (cache->lookup(start, goal, cached)) {
+            return cached;
+        }
+
+        double distance;
+        if (!searchPath(start, goal, distance)) {
+            return fallbackToOSRM(start, goal);
+        }
+        cache->store(start, goal, distance);
+        return distance;
+    }
+
+    /**
+     * Run the A* search without consulting the cache, falling back to the
+     * straight-line distance when no path is found
+     * @param start Start point
+     * @param goal Goal point
+     * @return Distance in kilometers
+     */
+    double computePath(const Point& start, const Point& goal) {
+        double distance;
+        return searchPath(start, goal, distance) ? distance : fallbackToOSRM(start, goal);
+    }
+
+    /**
+     * Run the A* search only, without cache or fallback
+     * @param start Start point
+     * @param goal Goal point
+     * @param distance Path distance in km, set when a path was found
+     * @return False if the goal is beyond the search distance or off the
+     *         grid, or no path exists
+     */
+    bool searchPath(const Point& start, const Point& goal, double& distance) {
+        if (start.distanceTo(goal) > maxDistance) {
+            return false;
         }
 
         try {
@@ -74,22 +114,33 @@ public:
             auto path = aStarSearch(grid, start, goal);
             
             if (path.empty()) {
-                // Fallback to OSRM if A* fails
-                return fallbackToOSRM(start, goal);
+                return false;
             }
 
-            double distance = calculatePathDistance(path);
-            
-            // Cache the result
-            cache[cacheKey] = distance;
-            
-            return distance;
+            distance = calculatePathDistance(path);
+            return true;
         } catch (const std::exception& e) {
             std::cerr << "A* pathfinding failed: " << e.what() << std::endl;
-            return fallbackToOSRM(start, goal);
+            return false;
         }
     }
 
+    /**
+     * Set the straight-line distance above which A* returns the fallback distance
+     * @param maxDistanceKm Maximum search distance in km
+     */
+    void setMaxDistance(double maxDistanceKm) {
+        maxDistance = maxDistanceKm;
+    }
+
+    /**
+     * Get the maximum A* search distance
+     * @return Maximum search distance in km
+     */
+    double getMaxDistance() const {
+        return maxDistance;
+    }
+
     /**
      * Set progress callback function
      * @param callback Function to call for progress updates
@@ -98,11 +149,23 @@ public:
         progressCallback = callback;
     }
 
+    /**
+     * Share a distance cache, e.g. the one of RoadDistanceService
+     * @param distanceCache Cache to read through
+     */
+    void setDistanceCache(std::shared_ptr<DistanceCache> distanceCache) {
+        cache = distanceCache;
+    }
+
+    std::shared_ptr<DistanceCache> getDistanceCache() const {
+        return cache;
+    }
+
     /**
      * Clear cache
      */
     void clearCache() {
-        cache.clear();
+        cache->clear();
     }
 
     /**
@@ -111,7 +174,7 @@ public:
      */
     std::map<std::string, int> getCacheStats() const {
         std::map<std::string, int> stats;
-        stats["size"] = cache.size();
+        stats["size"] = static_cast<int>(cache->size());
         stats["max_distance"] = static_cast<int>(maxDistance);
         stats["grid_size"] = static_cast<int>(gridSize * 1000); // Convert to meters
         return stats;
@@ -360,29 +423,6 @@ private:
         // In a full implementation, this would make HTTP requests to OSRM
         return start.distanceTo(goal);
     }
-
-    /**
-     * Get cache key for two points
-     * @param point1 First point
-     * @param point2 Second point
-     * @return Cache key
-     */
-    std::string getCacheKey(const Point& point1, const Point& point2) {
-        std::ostringstream keyStream;
-        
-        if (point1.latitude < point2.latitude || 
-            (point1.latitude == point2.latitude && point1.longitude < point2.longitude)) {
-            keyStream << std::fixed << std::setprecision(6) 
-                      << point1.latitude << "," << point1.longitude << "|"
-                      << point2.latitude << "," << point2.longitude;
-        } else {
-            keyStream << std::fixed << std::setprecision(6) 
-                      << point2.latitude << "," << point2.longitude << "|"
-                      << point1.latitude << "," << point1.longitude;
-        }
-        
-        return keyStream.str();
-    }
 };
 
 #endif // ASTAR_ALGORITHM_H
@@ -7,7 +7,32 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
 #include "RoadDistanceService.h"
+#include "LazyDistanceMatrix.h"
+#include "CandidateDistanceMatrix.h"
+#include "NearestAvailableCursor.h"
+#include "MatrixRowCandidates.h"
+#include "SlotSchedule.h"
+#include "MaskedArgmin.h"
+#include "MinCostFlowAssignment.h"
+#include "AuctionAssignment.h"
+#include "IncrementalAssignment.h"
+#include "PersonSource.h"
+#include "StreamingStats.h"
+#include "LocalSearchImprover.h"
+#include "RegionalAssignment.h"
+#include "FacilitySelection.h"
+
+enum class AssignmentEngine {
+    Greedy,      // Nearest available center in priority order
+    MinCostFlow, // Optimal per tier (cost-scaling min-cost flow)
+    Auction      // Optimal per tier (parallel epsilon-scaling auction)
+};
 
 struct AssignmentResult {
     int personIndex;
@@ -16,9 +41,10 @@ struct AssignmentResult {
     Point center;
     double distance;
     std::string category;
+    int slotIndex; // Slot at the center (0 without a slot schedule)
     
     AssignmentResult(int pIdx, int cIdx, const Point& p, const Point& c, double dist, const std::string& cat)
-        : personIndex(pIdx), centerIndex(cIdx), person(p), center(c), distance(dist), category(cat) {}
+        : personIndex(pIdx), centerIndex(cIdx), person(p), center(c), distance(dist), category(cat), slotIndex(0) {}
 };
 
 struct AssignmentStats {
@@ -29,24 +55,70 @@ struct AssignmentStats {
     double averageDistance;
     double maxDistance;
     double minDistance;
+    double distanceStdDev;
+    double p50Distance; // Quantiles within 1% (see getAssignmentDistribution)
+    double p90Distance;
+    double p99Distance;
     
     AssignmentStats() : totalAssigned(0), pwdAssigned(0), femaleAssigned(0), maleAssigned(0),
-                       averageDistance(0), maxDistance(0), minDistance(std::numeric_limits<double>::max()) {}
+                       averageDistance(0), maxDistance(0), minDistance(std::numeric_limits<double>::max()),
+                       distanceStdDev(0), p50Distance(0), p90Distance(0), p99Distance(0) {}
 };
 
 class AssignmentAlgorithm {
 private:
-    std::map<int, int> assignments; // personId -> testCenterId
-    std::map<int, int> testCenterCapacity; // testCenterId -> remaining capacity
-    AssignmentStats assignmentStats;
+    static constexpr int PRIORITY_TIERS = 4; // pwd, female, male, other
+    static constexpr size_t NEAREST_LIST_SIZE = 8; // Sorted centers per person on the dense path
+    static constexpr size_t DEFAULT_STREAM_CHUNK = 4096; // People per streaming chunk
+    static constexpr size_t PARALLEL_STATS_THRESHOLD = 1 << 16; // Results before statistics are split across threads
+    static constexpr int FACILITY_CANDIDATES = 32; // Minimum candidate sites per person when selecting centers
+    static constexpr double ROAD_DETOUR_BOUND = 2.5; // Road / straight-line ratio for the initial Fixed16 range (widened on overflow)
+    
+    std::vector<int> assignments; // personId -> testCenterId, -1 if unassigned
+    std::vector<int> assignedSlot; // personId -> slot at the assigned center, -1 if unassigned
+    SlotSchedule slotSchedule; // Slots of the last run (one per center without a schedule)
+    
+    // Center state, indexed by testCenterId and kept in step by takeCenterUnit()
+    // and setRemainingCapacity()
+    std::vector<int> testCenterCapacity; // Remaining capacity
+    std::vector<char> centerFull; // Byte mask: no capacity left
+    std::vector<float> centerPenalty; // 0 when open, +inf when full (row + penalty = masked distances)
+    mutable AssignmentStats assignmentStats;
+    mutable AssignmentDistribution distribution; // Sketches behind assignmentStats
     RoadDistanceService* roadDistanceService;
     bool useRoadDistances;
+    bool useLazyEvaluation;
+    int candidateCount; // 0 = dense matrix
+    MatrixPrecision matrixPrecision;
+    MatrixLayout matrixLayout;
+    std::string matrixFile; // Empty = heap matrix
+    AssignmentEngine assignmentEngine;
+    int auctionThreads; // 0 = hardware concurrency
+    bool useIncrementalUpdates;
+    double localSearchBudget; // Seconds, 0 = no improvement phase
+    LocalSearchObjective localSearchObjective;
+    int localSearchThreads; // 0 = hardware concurrency
+    int regionCount; // <= 1 = no geographic decomposition
+    double regionOverlapKm;
+    int regionThreads; // 0 = hardware concurrency
+    bool regionGapCheck; // Compare regional runs with a global greedy run
+    std::unique_ptr<IncrementalAssignment> incremental; // Seeded by the last full run
+    std::map<std::string, double> facilityStats; // Last selectTestCenters run
+    std::vector<std::string> priorityCategories; // Served first to last; others share the last tier
+    bool verbose; // Progress and solver statistics on std::cout
+    mutable bool statsStale; // Incremental updates since the stats were built (rebuilt on read)
     
     // Progress callback function type
     std::function<void(int, int, const std::string&)> progressCallback;
 
 public:
-    AssignmentAlgorithm() : roadDistanceService(nullptr), useRoadDistances(true) {}
+    AssignmentAlgorithm() : roadDistanceService(nullptr), useRoadDistances(true), useLazyEvaluation(false), candidateCount(0),
+                            matrixPrecision(MatrixPrecision::Float32), matrixLayout(MatrixLayout::PersonMajor),
+                            assignmentEngine(AssignmentEngine::Greedy), auctionThreads(0),
+                            useIncrementalUpdates(false), localSearchBudget(0.0),
+                            localSearchObjective(LocalSearchObjective::TotalDistance), localSearchThreads(0),
+                            regionCount(0), regionOverlapKm(5.0), regionThreads(0), regionGapCheck(false),
+                            priorityCategories{"pwd", "female", "male"}, verbose(true), statsStale(false) {}
 
     /**
      * Assign people to test centers with priority
@@ -62,133 +134,743 @@ public:
         int capacityPerCenter = 50,
         RoadDistanceService* roadService = nullptr) {
         
-        // Reset assignments
-        assignments.clear();
-        testCenterCapacity.clear();
+        return assignPeopleToScheduledCenters(people, testCenters,
+                                              SlotSchedule(testCenters.size(), 1, capacityPerCenter), roadService);
+    }
+
+    /**
+     * Assign people to (test center, slot) pairs with priority. Distance does
+     * not depend on the slot, so every engine runs on one capacity per center
+     * (the sum of its slots) over the usual P x C distances; people are then
+     * given the earliest slot with room at their center, in priority order.
+     * @param people Vector of people points
+     * @param testCenters Vector of test center points
+     * @param schedule Slots and slot capacities of every center
+     * @param roadService Road distance service
+     * @return Assignment results with slotIndex set
+     */
+    std::vector<AssignmentResult> assignPeopleToScheduledCenters(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters, 
+        const SlotSchedule& schedule,
+        RoadDistanceService* roadService = nullptr) {
         
         // Set road distance service
         roadDistanceService = roadService;
         
-        // Initialize test center capacities
-        for (size_t i = 0; i < testCenters.size(); i++) {
-            testCenterCapacity[i] = capacityPerCenter;
-        }
+        beginRun(people, testCenters, schedule);
 
-        // Calculate all distances (road-based or Haversine)
-        std::vector<std::vector<double>> distanceMatrix = calculateDistanceMatrix(people, testCenters);
+        // Order person indices by priority (PWD > Female > Male)
+        std::vector<int> priorityOrder = sortPeopleByPriority(people);
         
-        // Sort people by priority (PWD > Female > Male)
-        std::vector<Point> sortedPeople = sortPeopleByPriority(people);
+        std::vector<AssignmentResult> assignmentResults;
         
-        // Assign people using priority-based greedy algorithm
-        std::vector<AssignmentResult> assignmentResults = performPriorityAssignment(
-            sortedPeople, testCenters, distanceMatrix);
+        if (regionCount > 1) {
+            // Solve geographic regions in parallel and reconcile their borders
+            assignmentResults = performRegionalAssignment(people, testCenters);
+        } else if (candidateCount > 0) {
+            // Keep only the k nearest centers per person
+            if (verbose) {
+                std::cout << "Using sparse " << candidateCount << "-nearest candidate distances..." << std::endl;
+            }
+            CandidateDistanceMatrix candidateMatrix(people, testCenters, candidateCount,
+                [this](const Point& a, const Point& b) {
+                    return exactDistance(a, b);
+                });
+            
+            if (assignmentEngine != AssignmentEngine::Greedy) {
+                assignmentResults = performOptimalAssignment(people, priorityOrder, testCenters,
+                    [&candidateMatrix](int personIndex) -> const std::vector<DistanceCandidate>& {
+                        return candidateMatrix.getCandidates(personIndex);
+                    },
+                    [&candidateMatrix](int personIndex) {
+                        return candidateMatrix.extendCandidateList(personIndex);
+                    });
+            } else {
+                assignmentResults = performSparsePriorityAssignment(people, priorityOrder, testCenters, candidateMatrix);
+            }
+            
+            auto evaluation = candidateMatrix.getEvaluationStats();
+            if (verbose) {
+                std::cout << "Sparse matrix computed " << evaluation["evaluated_pairs"] << "/"
+                          << evaluation["total_pairs"] << " distances" << std::endl;
+            }
+        } else if (useLazyEvaluation && useRoadDistances && roadDistanceService &&
+                   assignmentEngine == AssignmentEngine::Greedy) {
+            // Evaluate road distances on demand, pruned by Haversine lower bounds
+            if (verbose) {
+                std::cout << "Using lazy road-based distance evaluation..." << std::endl;
+            }
+            LazyDistanceMatrix lazyMatrix(people, testCenters, [this](const Point& a, const Point& b) {
+                return roadDistanceService->calculateRoadDistance(a, b);
+            });
+            
+            assignmentResults = performLazyPriorityAssignment(people, priorityOrder, testCenters, lazyMatrix);
+            
+            auto evaluation = lazyMatrix.getEvaluationStats();
+            if (verbose) {
+                std::cout << "Lazy evaluation computed " << evaluation["evaluated_pairs"] << "/"
+                          << evaluation["total_pairs"] << " road distances" << std::endl;
+            }
+        } else {
+            // Calculate all distances (road-based or Haversine)
+            DistanceMatrix distanceMatrix = calculateDistanceMatrix(people, testCenters);
+            bool straightLine = !(useRoadDistances && roadDistanceService);
+            assignmentResults = performDenseAssignment(people, priorityOrder, testCenters, distanceMatrix, straightLine);
+        }
         
-        // Calculate statistics
-        calculateAssignmentStats(assignmentResults);
+        finishRun(people, testCenters, assignmentResults);
+        return assignmentResults;
+    }
+
+    /**
+     * Assign people against a distance matrix computed or loaded beforehand,
+     * so several runs can share it. Always uses the dense path with the
+     * selected engine; lazy, sparse and regional settings are ignored.
+     * @param people Vector of people points (matrix rows)
+     * @param testCenters Vector of test center points (matrix columns)
+     * @param schedule Slots and slot capacities of every center
+     * @param distanceMatrix Precomputed P x C matrix, only read
+     * @param roadService Road distance service (incremental updates only)
+     * @return Assignment results with slotIndex set
+     */
+    std::vector<AssignmentResult> assignPeopleWithMatrix(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters, 
+        const SlotSchedule& schedule,
+        const DistanceMatrix& distanceMatrix,
+        RoadDistanceService* roadService = nullptr) {
         
+        if (distanceMatrix.getPersonCount() != people.size() || distanceMatrix.getCenterCount() != testCenters.size()) {
+            throw std::runtime_error("Distance matrix is " + std::to_string(distanceMatrix.getPersonCount()) + " x " +
+                                     std::to_string(distanceMatrix.getCenterCount()) + ", expected " +
+                                     std::to_string(people.size()) + " x " + std::to_string(testCenters.size()));
+        }
+        roadDistanceService = roadService;
+        beginRun(people, testCenters, schedule);
+        
+        std::vector<AssignmentResult> assignmentResults = performDenseAssignment(
+            people, sortPeopleByPriority(people), testCenters, distanceMatrix);
+        
+        finishRun(people, testCenters, assignmentResults);
         return assignmentResults;
     }
 
+    /**
+     * Compute the distance matrix a later assignPeopleWithMatrix call (or
+     * many) will share, with the current road, storage and file settings
+     * @param people Vector of people points
+     * @param testCenters Vector of test center points
+     * @param roadService Road distance service (straight-line when null)
+     * @return Distance matrix
+     */
+    DistanceMatrix prepareDistanceMatrix(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters, 
+        RoadDistanceService* roadService = nullptr) {
+        
+        roadDistanceService = roadService;
+        return calculateDistanceMatrix(people, testCenters);
+    }
+
+    /**
+     * Assign an unbounded stream of people chunk by chunk. The source is read
+     * once per priority tier; each chunk of that tier gets k-nearest candidate
+     * distances and is assigned greedily in stream order, so the result equals
+     * the sparse greedy assignment. Neither the full matrix nor the full result
+     * list is ever built: results go to the callback and memory stays
+     * O(chunkSize * k + C). getAssignments() is not filled in this mode.
+     * @param source People source (rewound once per tier)
+     * @param testCenters Vector of test center points
+     * @param capacityPerCenter Maximum people per test center
+     * @param onResult Called for every assignment; personIndex is the stream position
+     * @param roadService Road distance service
+     * @param chunkSize People per chunk
+     * @return Assignment statistics
+     */
+    AssignmentStats assignPeopleStreaming(
+        PersonSource& source,
+        const std::vector<Point>& testCenters,
+        int capacityPerCenter,
+        const std::function<void(const AssignmentResult&)>& onResult,
+        RoadDistanceService* roadService = nullptr,
+        size_t chunkSize = DEFAULT_STREAM_CHUNK) {
+        
+        assignments.clear();
+        assignedSlot.clear();
+        slotSchedule = SlotSchedule();
+        incremental.reset();
+        roadDistanceService = roadService;
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        
+        resetCenterState(std::vector<int>(testCenters.size(), capacityPerCenter));
+        size_t openCenters = capacityPerCenter > 0 ? testCenters.size() : 0;
+        
+        int k = candidateCount > 0 ? candidateCount : static_cast<int>(NEAREST_LIST_SIZE);
+        auto distanceFn = [this](const Point& a, const Point& b) {
+            return exactDistance(a, b);
+        };
+        if (verbose) {
+            std::cout << "Streaming assignment in chunks of " << chunkSize << " people ("
+                      << k << " candidates each)..." << std::endl;
+        }
+        
+        resetAssignmentStats(std::vector<int>(testCenters.size(), capacityPerCenter));
+        
+        std::vector<Point> chunk;
+        std::vector<int> chunkIndices;
+        chunk.reserve(chunkSize);
+        chunkIndices.reserve(chunkSize);
+        
+        for (int tier = 0; tier < PRIORITY_TIERS && openCenters > 0; tier++) {
+            source.reset();
+            Point person;
+            int streamIndex = 0;
+            long long tierPeople = 0;
+            bool more = true;
+            
+            while (more && openCenters > 0) {
+                chunk.clear();
+                chunkIndices.clear();
+                while (chunk.size() < chunkSize && (more = source.next(person))) {
+                    if (priorityTier(person.category) == tier) {
+                        chunk.push_back(person);
+                        chunkIndices.push_back(streamIndex);
+                    }
+                    streamIndex++;
+                }
+                if (chunk.empty()) continue;
+                tierPeople += chunk.size();
+                
+                CandidateDistanceMatrix candidateMatrix(chunk, testCenters, k, distanceFn);
+                for (size_t i = 0; i < chunk.size() && openCenters > 0; i++) {
+                    auto bestAssignment = candidateMatrix.findBestAvailable(i, [this](int centerIndex) {
+                        return !centerFull[centerIndex];
+                    });
+                    if (bestAssignment.first == -1) continue;
+                    
+                    int centerIndex = bestAssignment.first;
+                    if (takeCenterUnit(centerIndex)) {
+                        openCenters--;
+                    }
+                    
+                    AssignmentResult result(chunkIndices[i], centerIndex, chunk[i], testCenters[centerIndex],
+                                            bestAssignment.second, chunk[i].category);
+                    accumulateAssignmentStats(result);
+                    onResult(result);
+                }
+                
+                if (progressCallback) {
+                    progressCallback(assignmentStats.totalAssigned, streamIndex, "streaming");
+                }
+            }
+            
+            if (verbose) {
+                std::cout << "Streamed tier " << tier << ": " << tierPeople << " people" << std::endl;
+            }
+        }
+        
+        finishAssignmentStats();
+        return assignmentStats;
+    }
+
+    /**
+     * Choose which candidate sites to open as test centers (capacitated
+     * p-median by lazy greedy-add plus fast interchange over the nearest
+     * max(32, 3N / openCount) candidate sites of each person), then assign people to the opened sites with the
+     * configured engine. getAssignments() and the results then index the
+     * returned list of sites.
+     * @param people Vector of people points
+     * @param candidateSites Candidate test center locations
+     * @param openCount Number of sites to open
+     * @param capacityPerCenter Maximum people per opened site
+     * @param roadService Road distance service
+     * @param budgetSeconds Interchange time budget (0 = until no swap improves)
+     * @param threads Threads pricing swaps (0 = hardware concurrency)
+     * @return Indices of the opened sites, ascending
+     */
+    std::vector<int> selectTestCenters(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& candidateSites, 
+        int openCount,
+        int capacityPerCenter = 50,
+        RoadDistanceService* roadService = nullptr,
+        double budgetSeconds = 0.0,
+        int threads = 0) {
+        
+        roadDistanceService = roadService;
+        openCount = std::max(openCount, 1);
+        
+        // About three open sites among each person's candidates, so few go unserved
+        int k = static_cast<int>(std::min<size_t>(candidateSites.size(),
+            std::max<size_t>(FACILITY_CANDIDATES, (3 * candidateSites.size() + openCount - 1) / openCount)));
+        if (verbose) {
+            std::cout << "Selecting " << openCount << " of " << candidateSites.size() << " sites ("
+                      << k << " candidate sites per person)..." << std::endl;
+        }
+        
+        CandidateDistanceMatrix candidateMatrix(people, candidateSites, k,
+            [this](const Point& a, const Point& b) {
+                return exactDistance(a, b);
+            });
+        FacilitySelection selection(people.size(), std::vector<int>(candidateSites.size(), capacityPerCenter),
+            [&candidateMatrix](int personIndex) -> const std::vector<DistanceCandidate>& {
+                return candidateMatrix.getCandidates(personIndex);
+            });
+        selection.setThreadCount(threads);
+        std::vector<int> opened = selection.select(openCount, budgetSeconds);
+        
+        facilityStats = selection.getSelectionStats();
+        if (verbose) {
+            std::cout << "Facility selection: nearest-site total " << facilityStats["greedy_km"] << " km after greedy-add ("
+                      << facilityStats["greedy_ms"] << " ms), " << facilityStats["final_km"] << " km after "
+                      << facilityStats["swaps"] << " swaps (" << facilityStats["interchange_ms"] << " ms on "
+                      << facilityStats["threads"] << " threads), " << facilityStats["unserved"]
+                      << " people without an open candidate" << std::endl;
+        }
+        
+        // Capacitated cost of the chosen sites
+        std::vector<Point> openedSites;
+        for (int site : opened) {
+            openedSites.push_back(candidateSites[site]);
+        }
+        std::vector<AssignmentResult> results = assignPeopleToTestCenters(people, openedSites, capacityPerCenter,
+                                                                          roadService);
+        double capacitatedTotal = 0;
+        for (const auto& result : results) {
+            capacitatedTotal += result.distance;
+        }
+        facilityStats["assigned"] = results.size();
+        facilityStats["capacitated_km"] = capacitatedTotal;
+        if (verbose) {
+            std::cout << "Opened sites serve " << results.size() << "/" << people.size() << " people, "
+                      << capacitatedTotal << " km with capacities" << std::endl;
+        }
+        
+        return opened;
+    }
+
     /**
      * Calculate distance matrix between all people and test centers
      * @param people Vector of people
      * @param testCenters Vector of test centers
-     * @return Distance matrix [personIndex][centerIndex]
+     * @return Distance matrix
      */
-    std::vector<std::vector<double>> calculateDistanceMatrix(
+    DistanceMatrix calculateDistanceMatrix(
         const std::vector<Point>& people, 
         const std::vector<Point>& testCenters) {
         
-        std::vector<std::vector<double>> matrix(people.size(), std::vector<double>(testCenters.size()));
-        
         if (useRoadDistances && roadDistanceService) {
-            std::cout << "Calculating road-based distance matrix..." << std::endl;
-            matrix = roadDistanceService->calculateRoadDistanceMatrix(people, testCenters);
-        } else {
-            std::cout << "Calculating straight-line distance matrix..." << std::endl;
-            matrix = calculateHaversineDistanceMatrix(people, testCenters);
+            if (verbose) {
+                std::cout << "Calculating road-based distance matrix..." << std::endl;
+            }
+            double resolution = fixedResolutionFor(people, testCenters, ROAD_DETOUR_BOUND);
+            if (matrixFile.empty()) {
+                return roadDistanceService->calculateRoadDistanceMatrix(people, testCenters, matrixPrecision, matrixLayout,
+                                                                        resolution);
+            }
+            
+            DistanceMatrix matrix = DistanceMatrix::createMapped(
+                matrixFile, people.size(), testCenters.size(), matrixPrecision, matrixLayout, resolution);
+            roadDistanceService->fillRoadDistanceMatrix(people, testCenters, matrix);
+            return matrix;
         }
         
-        return matrix;
+        if (verbose) {
+            std::cout << "Calculating straight-line distance matrix..." << std::endl;
+        }
+        return calculateHaversineDistanceMatrix(people, testCenters);
+    }
+
+    /**
+     * Choose the Fixed16 resolution for a matrix over these points. The
+     * largest straight-line distance is bounded in O(P + C) by the triangle
+     * inequality through the first person: d(p, c) <= d(p, o) + d(o, c).
+     * @param people Vector of people
+     * @param testCenters Vector of test centers
+     * @param detour Factor applied for distances that may exceed straight-line
+     * @return Kilometers per Fixed16 unit (0.01 km for regional data)
+     */
+    double fixedResolutionFor(const std::vector<Point>& people, const std::vector<Point>& testCenters,
+                              double detour) const {
+        if (matrixPrecision != MatrixPrecision::Fixed16 || people.empty()) {
+            return DistanceMatrix::fixedResolutionFor(0.0);
+        }
+        const Point& origin = people.front();
+        double personReach = 0.0, centerReach = 0.0;
+        for (const auto& person : people) {
+            personReach = std::max(personReach, origin.distanceTo(person));
+        }
+        for (const auto& center : testCenters) {
+            centerReach = std::max(centerReach, origin.distanceTo(center));
+        }
+        return DistanceMatrix::fixedResolutionFor((personReach + centerReach) * detour);
     }
 
     /**
      * Calculate Haversine distance matrix (fallback)
      * @param people Vector of people
      * @param testCenters Vector of test centers
-     * @return Distance matrix [personIndex][centerIndex]
+     * @return Distance matrix
      */
-    std::vector<std::vector<double>> calculateHaversineDistanceMatrix(
+    DistanceMatrix calculateHaversineDistanceMatrix(
         const std::vector<Point>& people, 
         const std::vector<Point>& testCenters) {
         
-        std::vector<std::vector<double>> matrix(people.size(), std::vector<double>(testCenters.size()));
+        double resolution = fixedResolutionFor(people, testCenters, 1.0);
+        DistanceMatrix matrix = matrixFile.empty() ?
+            DistanceMatrix(people.size(), testCenters.size(), matrixPrecision, matrixLayout, resolution) :
+            DistanceMatrix::createMapped(matrixFile, people.size(), testCenters.size(), matrixPrecision, matrixLayout,
+                                         resolution);
         
         for (size_t i = 0; i < people.size(); i++) {
             for (size_t j = 0; j < testCenters.size(); j++) {
-                matrix[i][j] = people[i].distanceTo(testCenters[j]);
+                matrix.set(i, j, people[i].distanceTo(testCenters[j]));
             }
         }
+        matrix.padRows(0, matrix.getStorageRowCount());
         
         return matrix;
     }
 
     /**
-     * Sort people by priority (PWD > Female > Male)
+     * Get priority tier of a category (0 = served first)
+     * @param category Person category
+     * @return Tier index; categories outside the priority order come last
+     */
+    int priorityTier(const std::string& category) const {
+        for (size_t tier = 0; tier < priorityCategories.size(); tier++) {
+            if (category == priorityCategories[tier]) return static_cast<int>(tier);
+        }
+        return PRIORITY_TIERS - 1;
+    }
+
+    /**
+     * Set the order in which categories are served
+     * @param categories Categories served first to last (empty restores pwd, female, male);
+     *                   other categories share the last tier
+     */
+    void setPriorityOrder(const std::vector<std::string>& categories) {
+        if (categories.size() > static_cast<size_t>(PRIORITY_TIERS)) {
+            throw std::runtime_error("At most " + std::to_string(PRIORITY_TIERS) + " priority categories are supported");
+        }
+        priorityCategories = categories.empty() ? std::vector<std::string>{"pwd", "female", "male"} : categories;
+    }
+
+    const std::vector<std::string>& getPriorityOrder() const {
+        return priorityCategories;
+    }
+
+    /**
+     * Order people by priority (PWD > Female > Male) with a stable counting
+     * sort of their indices; people keep their input order within a tier
      * @param people Vector of people
-     * @return Sorted people vector
+     * @return Person indices in assignment order
      */
-    std::vector<Point> sortPeopleByPriority(const std::vector<Point>& people) {
-        std::vector<Point> sortedPeople = people;
+    std::vector<int> sortPeopleByPriority(const std::vector<Point>& people) const {
+        std::vector<unsigned char> tiers(people.size());
+        std::vector<size_t> tierStart(PRIORITY_TIERS + 1, 0);
         
-        std::sort(sortedPeople.begin(), sortedPeople.end(), [](const Point& a, const Point& b) {
-            std::map<std::string, int> priorityOrder = {{"pwd", 1}, {"female", 2}, {"male", 3}};
-            return priorityOrder[a.category] < priorityOrder[b.category];
-        });
+        for (size_t i = 0; i < people.size(); i++) {
+            tiers[i] = static_cast<unsigned char>(priorityTier(people[i].category));
+            tierStart[tiers[i] + 1]++;
+        }
+        for (int tier = 0; tier < PRIORITY_TIERS; tier++) {
+            tierStart[tier + 1] += tierStart[tier];
+        }
+        
+        std::vector<int> order(people.size());
+        for (size_t i = 0; i < people.size(); i++) {
+            order[tierStart[tiers[i]]++] = static_cast<int>(i);
+        }
+        
+        return order;
+    }
+
+    /**
+     * Assign over a dense matrix with the selected engine
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order
+     * @param testCenters Test centers
+     * @param distanceMatrix Dense distance matrix
+     * @param straightLine Entries are straight-line distances between these points
+     * @return Assignment results
+     */
+    std::vector<AssignmentResult> performDenseAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
+        const std::vector<Point>& testCenters, 
+        const DistanceMatrix& distanceMatrix,
+        bool straightLine = false) {
+        
+        if (assignmentEngine == AssignmentEngine::Greedy) {
+            // Assign people using priority-based greedy algorithm
+            return performPriorityAssignment(people, priorityOrder, testCenters, distanceMatrix, straightLine);
+        }
         
-        return sortedPeople;
+        // Every reachable center is a candidate, read row by row from the
+        // (possibly shared) matrix; use setCandidateCount() for large inputs
+        MatrixRowCandidates rowCandidates(distanceMatrix);
+        return performOptimalAssignment(people, priorityOrder, testCenters,
+            [&rowCandidates](int personIndex) -> const std::vector<DistanceCandidate>& {
+                return rowCandidates.getCandidates(personIndex);
+            });
     }
 
     /**
      * Perform priority-based assignment
-     * @param sortedPeople People sorted by priority
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order
      * @param testCenters Test centers
      * @param distanceMatrix Pre-calculated distance matrix
+     * @param straightLine Entries are straight-line distances between these points
      * @return Assignment results
      */
     std::vector<AssignmentResult> performPriorityAssignment(
-        const std::vector<Point>& sortedPeople, 
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
         const std::vector<Point>& testCenters, 
-        const std::vector<std::vector<double>>& distanceMatrix) {
+        const DistanceMatrix& distanceMatrix,
+        bool straightLine) {
         
-        std::vector<AssignmentResult> results;
+        // Rows are visited in ascending order within each priority tier, so a
+        // file-backed matrix is streamed tile by tile
+        const size_t streamTile = 1024;
+        size_t currentTile = std::numeric_limits<size_t>::max();
+        bool streamRows = distanceMatrix.isMapped() && distanceMatrix.getLayout() == MatrixLayout::PersonMajor;
+        if (streamRows) {
+            distanceMatrix.adviseSequential();
+        }
+        
+        // Each person is queried once, so a contiguous float row is best served
+        // by one SIMD masked argmin; other storage uses sorted nearest lists,
+        // seeded from a center index when the entries are straight-line
+        bool floatRows = distanceMatrix.getPrecision() == MatrixPrecision::Float32 &&
+                         distanceMatrix.getLayout() == MatrixLayout::PersonMajor;
+        std::unique_ptr<NearestAvailableCursor> nearestAvailable;
+        if (!floatRows) {
+            nearestAvailable.reset(new NearestAvailableCursor(distanceMatrix, NEAREST_LIST_SIZE));
+            if (straightLine) {
+                nearestAvailable->useStraightLineBound(people, testCenters);
+            }
+        }
+        
+        std::vector<AssignmentResult> results = assignInPriorityOrder(people, priorityOrder, testCenters, [&](int personIndex) {
+            size_t tile = personIndex / streamTile;
+            if (streamRows && tile != currentTile) {
+                if (currentTile != std::numeric_limits<size_t>::max()) {
+                    distanceMatrix.releaseRows(currentTile * streamTile, (currentTile + 1) * streamTile);
+                }
+                distanceMatrix.prefetchRows(tile * streamTile, (tile + 1) * streamTile);
+                currentTile = tile;
+            }
+            return floatRows ? findBestAvailableCenter(personIndex, testCenters, distanceMatrix) :
+                nearestAvailable->findBestAvailable(personIndex, centerFull);
+        });
+        
+        if (localSearchBudget > 0) {
+            improveAssignment(people, testCenters, results, [&distanceMatrix](int personIndex, int centerIndex) {
+                return distanceMatrix.get(personIndex, centerIndex);
+            });
+        }
+        return results;
+    }
+
+    /**
+     * Perform priority-based assignment with lazily evaluated road distances
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order
+     * @param testCenters Test centers
+     * @param lazyMatrix Lower-bound matrix evaluating exact distances on demand
+     * @return Assignment results
+     */
+    std::vector<AssignmentResult> performLazyPriorityAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
+        const std::vector<Point>& testCenters, 
+        LazyDistanceMatrix& lazyMatrix) {
+        
+        return assignInPriorityOrder(people, priorityOrder, testCenters, [&](int personIndex) {
+            return lazyMatrix.findBestAvailable(personIndex, [this](int centerIndex) {
+                return !centerFull[centerIndex];
+            });
+        });
+    }
+
+    /**
+     * Perform priority-based assignment over k-nearest candidate lists
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order
+     * @param testCenters Test centers
+     * @param candidateMatrix Sparse candidate distance matrix
+     * @return Assignment results
+     */
+    std::vector<AssignmentResult> performSparsePriorityAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
+        const std::vector<Point>& testCenters, 
+        CandidateDistanceMatrix& candidateMatrix) {
+        
+        return assignInPriorityOrder(people, priorityOrder, testCenters, [&](int personIndex) {
+            return candidateMatrix.findBestAvailable(personIndex, [this](int centerIndex) {
+                return !centerFull[centerIndex];
+            });
+        });
+    }
+
+    /**
+     * Perform optimal assignment tier by tier with the selected engine
+     * (min-cost flow or auction)
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order
+     * @param testCenters Test centers
+     * @param candidatesOf Candidate centers of a person
+     * @param extendCandidates Adds candidates when a person cannot be placed (optional)
+     * @return Assignment results
+     */
+    std::vector<AssignmentResult> performOptimalAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
+        const std::vector<Point>& testCenters, 
+        MinCostFlowAssignment::CandidateList candidatesOf,
+        MinCostFlowAssignment::CandidateExtender extendCandidates = nullptr) {
+        
+        std::vector<int> capacities(testCenterCapacity);
         
-        for (const Point& person : sortedPeople) {
-            // Find original index of this person
-            int originalPersonIndex = findPersonIndex(person, sortedPeople);
+        if (assignmentEngine == AssignmentEngine::Auction) {
+            AuctionAssignment solver(people.size(), capacities, candidatesOf, extendCandidates);
+            solver.setThreadCount(auctionThreads);
+            std::vector<AssignmentResult> results = assignByTier(people, priorityOrder, testCenters, solver);
             
-            // Find best available test center for this person
-            auto bestAssignment = findBestAvailableCenter(originalPersonIndex, testCenters, distanceMatrix);
+            auto solverStats = solver.getSolverStats();
+            if (verbose) {
+                std::cout << "Auction: " << solverStats["phases"] << " phases, " << solverStats["rounds"]
+                          << " rounds (" << solverStats["parallel_rounds"] << " parallel on "
+                          << solverStats["threads"] << " threads), " << solverStats["bids"] << " bids, "
+                          << solverStats["reverse_bids"] << " reverse bids, "
+                          << solverStats["extension_rounds"] << " candidate extension rounds" << std::endl;
+            }
+            return results;
+        }
+        
+        MinCostFlowAssignment solver(people.size(), capacities, candidatesOf, extendCandidates);
+        std::vector<AssignmentResult> results = assignByTier(people, priorityOrder, testCenters, solver);
+        
+        auto solverStats = solver.getSolverStats();
+        if (verbose) {
+            std::cout << "Min-cost flow: " << solverStats["refines"] << " refines, " << solverStats["pushes"]
+                      << " pushes, " << solverStats["relabels"] << " relabels, "
+                      << solverStats["extension_rounds"] << " candidate extension rounds" << std::endl;
+        }
+        
+        return results;
+    }
+
+    /**
+     * Perform greedy priority assignment per geographic region in parallel,
+     * then reconcile capacity conflicts on region borders
+     * @param people People in input order
+     * @param testCenters Test centers
+     * @return Assignment results in priority order
+     */
+    std::vector<AssignmentResult> performRegionalAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters) {
+        
+        std::vector<int> tiers(people.size());
+        for (size_t i = 0; i < people.size(); i++) {
+            tiers[i] = priorityTier(people[i].category);
+        }
+        std::vector<int> capacities(testCenterCapacity);
+        
+        // The road service is not thread-safe: each region thread gets its
+        // own worker service sharing the cache, or, when the transport cannot
+        // be duplicated (recording/replay), the regions share it in turn
+        std::mutex roadMutex;
+        bool road = useRoadDistances && roadDistanceService;
+        std::vector<std::unique_ptr<RoadDistanceService>> roadWorkers;
+        if (road) {
+            int threads = std::min(regionThreads > 0 ? regionThreads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())),
+                                   regionCount);
+            for (int t = 0; t < threads; t++) {
+                std::unique_ptr<RoadDistanceService> worker = roadDistanceService->createWorker();
+                if (!worker) {
+                    roadWorkers.clear();
+                    break;
+                }
+                roadWorkers.push_back(std::move(worker));
+            }
+        }
+        if (verbose) {
+            std::cout << "Using " << regionCount << " geographic regions (" << regionOverlapKm << " km overlap)";
+            if (road) {
+                if (roadWorkers.empty()) {
+                    std::cout << ", road queries serialized";
+                } else {
+                    std::cout << ", " << roadWorkers.size() << " road query workers";
+                }
+            }
+            std::cout << "..." << std::endl;
+        }
+        
+        RegionalAssignment regional(people, testCenters, tiers, capacities,
+            [this, road, &roadMutex](const Point& a, const Point& b) {
+                if (!road) return a.distanceTo(b);
+                std::lock_guard<std::mutex> lock(roadMutex);
+                return roadDistanceService->calculateRoadDistance(a, b);
+            },
+            candidateCount > 0 ? candidateCount : static_cast<int>(NEAREST_LIST_SIZE), regionCount, regionOverlapKm);
+        if (!roadWorkers.empty()) {
+            std::vector<RegionalAssignment::DistanceFunction> workerDistances;
+            for (const auto& worker : roadWorkers) {
+                RoadDistanceService* service = worker.get();
+                workerDistances.push_back([service](const Point& a, const Point& b) {
+                    return service->calculateRoadDistance(a, b);
+                });
+            }
+            regional.setWorkerDistances(workerDistances);
+        }
+        regional.setThreadCount(regionThreads);
+        regional.setGlobalComparison(regionGapCheck);
+        regional.solve();
+        
+        std::vector<AssignmentResult> results;
+        for (int personIndex : sortPeopleByPriority(people)) {
+            int centerIndex = regional.getAssignedCenter(personIndex);
+            if (centerIndex == -1) continue;
             
-            if (bestAssignment.first != -1) {
-                int centerIndex = bestAssignment.first;
-                double distance = bestAssignment.second;
-                
-                // Make assignment
-                assignments[originalPersonIndex] = centerIndex;
-                testCenterCapacity[centerIndex]--;
-                
-                results.emplace_back(originalPersonIndex, centerIndex, person, 
-                                   testCenters[centerIndex], distance, person.category);
+            assignments[personIndex] = centerIndex;
+            takeCenterUnit(centerIndex);
+            results.emplace_back(personIndex, centerIndex, people[personIndex], testCenters[centerIndex],
+                                 regional.getAssignedDistance(personIndex), people[personIndex].category);
+        }
+        
+        auto regionStats = regional.getRegionStats();
+        if (verbose) {
+            std::cout << "Regions: " << regionStats["regions"] << " (max " << regionStats["max_region_people"]
+                      << " people, " << regionStats["max_region_centers"] << " centers) solved in "
+                      << regionStats["solve_ms"] << " ms on " << regionStats["threads"] << " threads; "
+                      << regionStats["conflicts"] << " border conflicts, " << regionStats["repaired"]
+                      << " re-placed in " << regionStats["reconcile_ms"] << " ms";
+            if (regionGapCheck) {
+                std::cout << "; mean distance vs global greedy " << std::showpos << regionStats["gap_pct"] << "%"
+                          << std::noshowpos;
+                for (int tier = 0; tier < static_cast<int>(regionStats["tiers"]); tier++) {
+                    std::string prefix = "tier" + std::to_string(tier) + "_";
+                    std::cout << (tier == 0 ? " (" : ", ") << "tier " << tier << " " << std::showpos
+                              << regionStats[prefix + "gap_pct"] << "%" << std::noshowpos;
+                }
+                std::cout << ") measured in " << regionStats["gap_ms"] << " ms";
             }
+            std::cout << std::endl;
         }
         
         return results;
     }
 
     /**
-     * Find best available test center for a person
+     * Find best available test center for a person by scanning the whole row
+     * (SIMD masked argmin over Float32 person-major rows)
      * @param personIndex Person index
      * @param testCenters Test centers
      * @param distanceMatrix Distance matrix
@@ -197,15 +879,21 @@ public:
     std::pair<int, double> findBestAvailableCenter(
         int personIndex, 
         const std::vector<Point>& testCenters, 
-        const std::vector<std::vector<double>>& distanceMatrix) {
+        const DistanceMatrix& distanceMatrix) {
         
         int bestCenter = -1;
         double bestDistance = std::numeric_limits<double>::max();
         
-        for (size_t centerIndex = 0; centerIndex < testCenters.size(); centerIndex++) {
-            // Check if center has capacity
-            if (testCenterCapacity[centerIndex] > 0) {
-                double distance = distanceMatrix[personIndex][centerIndex];
+        if (distanceMatrix.getPrecision() == MatrixPrecision::Float32 &&
+            distanceMatrix.getLayout() == MatrixLayout::PersonMajor) {
+            // Contiguous row scan; full centers read as +inf through the penalty mask
+            float bestValue;
+            bestCenter = MaskedArgmin::find(distanceMatrix.floatRow(personIndex), centerPenalty.data(),
+                                            testCenters.size(), bestValue);
+            bestDistance = bestValue;
+        } else {
+            for (size_t centerIndex = 0; centerIndex < testCenters.size(); centerIndex++) {
+                double distance = distanceMatrix.get(personIndex, centerIndex) + centerPenalty[centerIndex];
                 
                 if (distance < bestDistance) {
                     bestDistance = distance;
@@ -214,24 +902,7 @@ public:
             }
         }
         
-        return (bestCenter != -1) ? std::make_pair(bestCenter, bestDistance) : std::make_pair(-1, -1);
-    }
-
-    /**
-     * Find person index in original vector
-     * @param person Person to find
-     * @param people Vector of people
-     * @return Index of person
-     */
-    int findPersonIndex(const Point& person, const std::vector<Point>& people) {
-        for (size_t i = 0; i < people.size(); i++) {
-            if (std::abs(people[i].latitude - person.latitude) < 1e-6 &&
-                std::abs(people[i].longitude - person.longitude) < 1e-6 &&
-                people[i].category == person.category) {
-                return i;
-            }
-        }
-        return -1;
+        return (bestCenter != -1) ? std::make_pair(bestCenter, bestDistance) : std::make_pair(-1, -1.0);
     }
 
     /**
@@ -239,34 +910,39 @@ public:
      * @param assignmentResults Assignment results
      */
     void calculateAssignmentStats(const std::vector<AssignmentResult>& assignmentResults) {
-        assignmentStats.totalAssigned = assignmentResults.size();
-        assignmentStats.pwdAssigned = 0;
-        assignmentStats.femaleAssigned = 0;
-        assignmentStats.maleAssigned = 0;
-        
-        double totalDistance = 0;
-        std::vector<double> distances;
+        std::vector<int> capacities = slotSchedule.getCenterCapacities();
+        resetAssignmentStats(capacities);
         
-        for (const auto& result : assignmentResults) {
-            // Count by category
-            if (result.category == "pwd") {
-                assignmentStats.pwdAssigned++;
-            } else if (result.category == "female") {
-                assignmentStats.femaleAssigned++;
-            } else if (result.category == "male") {
-                assignmentStats.maleAssigned++;
+        int threads = std::min<int>(std::max(1u, std::thread::hardware_concurrency()),
+                                    static_cast<int>(assignmentResults.size() / (PARALLEL_STATS_THRESHOLD / 2)));
+        if (assignmentResults.size() < PARALLEL_STATS_THRESHOLD || threads < 2) {
+            for (const auto& result : assignmentResults) {
+                accumulateAssignmentStats(result);
+            }
+        } else {
+            // Each thread sketches a slice; the partial sketches merge exactly
+            std::vector<AssignmentDistribution> partial(threads, AssignmentDistribution(capacities));
+            std::vector<std::thread> workers;
+            size_t chunk = (assignmentResults.size() + threads - 1) / threads;
+            for (int t = 0; t < threads; t++) {
+                size_t begin = t * chunk;
+                size_t end = std::min(begin + chunk, assignmentResults.size());
+                workers.emplace_back([&assignmentResults, &partial, t, begin, end]() {
+                    for (size_t r = begin; r < end; r++) {
+                        const AssignmentResult& result = assignmentResults[r];
+                        partial[t].add(result.centerIndex, result.distance, result.category);
+                    }
+                });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            for (const AssignmentDistribution& part : partial) {
+                distribution.merge(part);
             }
-            
-            totalDistance += result.distance;
-            distances.push_back(result.distance);
         }
         
-        // Calculate distance statistics
-        if (!distances.empty()) {
-            assignmentStats.averageDistance = totalDistance / distances.size();
-            assignmentStats.maxDistance = *std::max_element(distances.begin(), distances.end());
-            assignmentStats.minDistance = *std::min_element(distances.begin(), distances.end());
-        }
+        finishAssignmentStats();
     }
 
     /**
@@ -277,6 +953,14 @@ public:
         useRoadDistances = enabled;
     }
 
+    /**
+     * Enable or disable progress and solver statistics on std::cout
+     * @param enabled Whether to print (default true)
+     */
+    void setVerbose(bool enabled) {
+        verbose = enabled;
+    }
+
     /**
      * Check if road distances are enabled
      * @return True if road distances are enabled
@@ -286,19 +970,59 @@ public:
     }
 
     /**
-     * Get assignment statistics
+     * Get assignment statistics of the current assignment (the last run
+     * plus any incremental updates since)
      * @return Assignment statistics
      */
     AssignmentStats getAssignmentStats() const {
+        refreshIncrementalStats();
         return assignmentStats;
     }
 
     /**
-     * Get assignments map
+     * Get the distance and utilization sketches of the current assignment:
+     * per category, per center and overall, with mean, variance and quantiles
+     * @return Assignment distribution
+     */
+    const AssignmentDistribution& getAssignmentDistribution() const {
+        refreshIncrementalStats();
+        return distribution;
+    }
+
+    /**
+     * Get assignments map
      * @return Assignments map
      */
     std::map<int, int> getAssignments() const {
-        return assignments;
+        std::map<int, int> assignmentMap;
+        for (size_t personIndex = 0; personIndex < assignments.size(); personIndex++) {
+            if (assignments[personIndex] != -1) {
+                assignmentMap.emplace_hint(assignmentMap.end(), personIndex, assignments[personIndex]);
+            }
+        }
+        return assignmentMap;
+    }
+
+    /**
+     * Get the slot of every assigned person at their center
+     * @return Map of person index to slot index
+     */
+    std::map<int, int> getSlotAssignments() const {
+        std::map<int, int> slotMap;
+        for (size_t personIndex = 0; personIndex < assignedSlot.size(); personIndex++) {
+            if (assignedSlot[personIndex] != -1) {
+                slotMap.emplace_hint(slotMap.end(), personIndex, assignedSlot[personIndex]);
+            }
+        }
+        return slotMap;
+    }
+
+    /**
+     * Get slot occupancy of the last run
+     * @return Slot count, capacity, used units and fully booked slots
+     */
+    std::map<std::string, long long> getSlotStats() const {
+        return slotSchedule.getSlotStats();
     }
 
     /**
@@ -306,8 +1030,14 @@ public:
      */
     void clearAssignments() {
         assignments.clear();
+        assignedSlot.clear();
+        slotSchedule = SlotSchedule();
         testCenterCapacity.clear();
+        centerFull.clear();
+        centerPenalty.clear();
         assignmentStats = AssignmentStats();
+        distribution = AssignmentDistribution();
+        incremental.reset();
     }
 
     /**
@@ -324,13 +1054,623 @@ public:
      */
     std::map<std::string, std::string> getComplexityInfo() const {
         std::map<std::string, std::string> info;
-        info["time_complexity"] = useRoadDistances ? "O(P * C * R) + O(P log P)" : "O(P * C + P log P)";
-        info["space_complexity"] = "O(P * C)";
-        info["description"] = useRoadDistances ? 
+        info["time_complexity"] = useRoadDistances ? "O(P * C * R) + O(P)" : "O(P * C + P)";
+        info["space_complexity"] = (candidateCount > 0 || regionCount > 1) ? "O(P * k)" : "O(P * C)";
+        info["description"] = assignmentEngine == AssignmentEngine::MinCostFlow ?
+            "Tier-by-tier optimal assignment by cost-scaling min-cost flow" :
+            assignmentEngine == AssignmentEngine::Auction ?
+            "Tier-by-tier optimal assignment by parallel epsilon-scaling auction" :
+            useRoadDistances ? 
             "Priority-based greedy assignment with road distance optimization" :
             "Priority-based greedy assignment with straight-line distance optimization";
         return info;
     }
+
+    /**
+     * Enable or disable lazy (lower-bound pruned) road distance evaluation
+     * @param enabled Whether to evaluate road distances on demand
+     */
+    void setLazyEvaluationEnabled(bool enabled) {
+        useLazyEvaluation = enabled;
+    }
+
+    /**
+     * Check if lazy road distance evaluation is enabled
+     * @return True if lazy evaluation is enabled
+     */
+    bool isLazyEvaluationEnabled() const {
+        return useLazyEvaluation;
+    }
+
+    /**
+     * Use sparse k-nearest candidate lists instead of a dense matrix
+     * @param k Candidates per person (0 restores the dense matrix)
+     */
+    void setCandidateCount(int k) {
+        candidateCount = std::max(k, 0);
+    }
+
+    /**
+     * Get number of candidates kept per person
+     * @return Candidates per person, 0 when dense
+     */
+    int getCandidateCount() const {
+        return candidateCount;
+    }
+
+    /**
+     * Set storage precision and layout for dense distance matrices
+     * @param precision Float32 or Fixed16 entries
+     * @param layout Person-major or center-major rows
+     */
+    void setMatrixStorage(MatrixPrecision precision, MatrixLayout layout = MatrixLayout::PersonMajor) {
+        matrixPrecision = precision;
+        matrixLayout = layout;
+    }
+
+    /**
+     * Choose between greedy and optimal (min-cost flow or auction) assignment
+     * @param engine Assignment engine
+     */
+    void setAssignmentEngine(AssignmentEngine engine) {
+        assignmentEngine = engine;
+    }
+
+    AssignmentEngine getAssignmentEngine() const {
+        return assignmentEngine;
+    }
+
+    /**
+     * Set number of threads computing auction bids
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void setAuctionThreads(int threads) {
+        auctionThreads = std::max(threads, 0);
+    }
+
+    int getAuctionThreads() const {
+        return auctionThreads;
+    }
+
+    /**
+     * Store dense distance matrices in a memory-mapped file instead of RAM
+     * @param path Matrix file (created or truncated per run); empty restores heap storage
+     */
+    void setMatrixFile(const std::string& path) {
+        matrixFile = path;
+    }
+
+    /**
+     * Keep the state of each full run so people and capacities can be
+     * updated afterwards without starting over
+     * @param enabled Whether assignPeopleToTestCenters seeds incremental updates
+     */
+    void setIncrementalUpdatesEnabled(bool enabled) {
+        useIncrementalUpdates = enabled;
+        if (!enabled) {
+            refreshIncrementalStats();
+            incremental.reset();
+        }
+    }
+
+    bool isIncrementalUpdatesEnabled() const {
+        return useIncrementalUpdates;
+    }
+
+    /**
+     * Add a person to the current assignment, repairing it locally
+     * @param person Person
+     * @return Index of the new person
+     */
+    int addPerson(const Point& person) {
+        requireIncremental();
+        int personIndex = incremental->addPerson(person, priorityTier(person.category));
+        applyIncrementalChanges();
+        return personIndex;
+    }
+
+    /**
+     * Remove a person from the current assignment, handing their unit on
+     * @param personIndex Person index
+     * @return False if the person does not exist or was already removed
+     */
+    bool removePerson(int personIndex) {
+        requireIncremental();
+        bool removed = incremental->removePerson(personIndex);
+        applyIncrementalChanges();
+        return removed;
+    }
+
+    /**
+     * Change the capacity of a single-slot test center in the current assignment
+     * @param centerIndex Test center index
+     * @param capacity New capacity
+     */
+    void setCenterCapacity(int centerIndex, int capacity) {
+        requireIncremental();
+        requireCenter(centerIndex);
+        if (slotSchedule.getSlotCount(centerIndex) > 1) {
+            throw std::runtime_error("Test center " + std::to_string(centerIndex) +
+                                     " has several slots; use setSlotCapacity");
+        }
+        setSlotCapacity(centerIndex, 0, capacity);
+    }
+
+    /**
+     * Change the capacity of one slot in the current assignment. The center
+     * capacity becomes the new slot sum; people left over in a shrunk slot
+     * move to another slot of the same center when it has room.
+     * @param centerIndex Test center index
+     * @param slot Slot within the center
+     * @param capacity New capacity
+     */
+    void setSlotCapacity(int centerIndex, int slot, int capacity) {
+        requireIncremental();
+        requireCenter(centerIndex);
+        if (slot < 0 || slot >= slotSchedule.getSlotCount(centerIndex)) {
+            throw std::runtime_error("Unknown slot " + std::to_string(slot) + " at test center " +
+                                     std::to_string(centerIndex));
+        }
+        slotSchedule.setSlotCapacity(centerIndex, slot, capacity);
+        incremental->setCenterCapacity(centerIndex, slotSchedule.getCenterCapacity(centerIndex));
+        applyIncrementalChanges();
+        statsStale = true; // Utilization is against the new capacity
+        refreshCenter(centerIndex);
+        
+        // Re-slot the latest arrivals of an overbooked slot
+        int overflow = slotSchedule.getSlotUsed(centerIndex, slot) - slotSchedule.getSlotCapacity(centerIndex, slot);
+        for (int personIndex = static_cast<int>(assignments.size()) - 1; personIndex >= 0 && overflow > 0; personIndex--) {
+            if (assignments[personIndex] != centerIndex || assignedSlot[personIndex] != slot) continue;
+            int newSlot = slotSchedule.takeSlot(centerIndex); // Never the overbooked slot
+            if (newSlot == -1) break;
+            slotSchedule.releaseSlot(centerIndex, slot);
+            assignedSlot[personIndex] = newSlot;
+            overflow--;
+        }
+    }
+
+    /**
+     * Run a local-search improvement phase (relocate, swap, ejection chain)
+     * after the dense greedy pass
+     * @param budgetSeconds Wall-clock budget (0 disables the phase)
+     * @param objective Lower total distance or the longest trips
+     * @param threads Threads evaluating moves (0 = hardware concurrency)
+     */
+    void setLocalSearch(double budgetSeconds, LocalSearchObjective objective = LocalSearchObjective::TotalDistance,
+                        int threads = 0) {
+        localSearchBudget = std::max(budgetSeconds, 0.0);
+        localSearchObjective = objective;
+        localSearchThreads = std::max(threads, 0);
+    }
+
+    double getLocalSearchBudget() const {
+        return localSearchBudget;
+    }
+
+    /**
+     * Split large runs into geographic regions solved in parallel
+     * @param regions Number of k-d regions (0 or 1 disables decomposition)
+     * @param overlapKm Border overlap so people can reach centers across it
+     * @param threads Threads solving regions (0 = hardware concurrency)
+     * @param compareGlobal Also run a serial global greedy assignment and
+     *                      report the per-tier gap to it (costs about as
+     *                      much as the regional run)
+     */
+    void setRegionalDecomposition(int regions, double overlapKm = 5.0, int threads = 0, bool compareGlobal = false) {
+        regionCount = std::max(regions, 0);
+        regionOverlapKm = std::max(overlapKm, 0.0);
+        regionThreads = std::max(threads, 0);
+        regionGapCheck = compareGlobal;
+    }
+
+    int getRegionCount() const {
+        return regionCount;
+    }
+
+    /**
+     * Get statistics of the last selectTestCenters run
+     * @return Greedy and interchange cost, swaps, timings and capacitated cost (empty before a run)
+     */
+    std::map<std::string, double> getFacilityStats() const {
+        return facilityStats;
+    }
+
+    /**
+     * Get incremental repair statistics
+     * @return Update, search, move and eviction counters (empty before a seeded run)
+     */
+    std::map<std::string, long long> getIncrementalStats() const {
+        return incremental ? incremental->getRepairStats() : std::map<std::string, long long>();
+    }
+
+private:
+    /**
+     * Distance of one pair: road distance when enabled and a road service
+     * is set, otherwise Haversine
+     * @param a First point
+     * @param b Second point
+     * @return Distance in kilometers
+     */
+    double exactDistance(const Point& a, const Point& b) {
+        return (useRoadDistances && roadDistanceService) ?
+            roadDistanceService->calculateRoadDistance(a, b) : a.distanceTo(b);
+    }
+
+    /**
+     * Set every center's capacity and open it (unless its capacity is 0)
+     * @param capacities Capacity per center
+     */
+    void resetCenterState(const std::vector<int>& capacities) {
+        testCenterCapacity.assign(capacities.size(), 0);
+        centerFull.assign(capacities.size(), 0);
+        centerPenalty.assign(capacities.size(), 0.0f);
+        for (size_t j = 0; j < capacities.size(); j++) {
+            setRemainingCapacity(j, capacities[j]);
+        }
+    }
+
+    /**
+     * Use one unit of a center
+     * @param centerIndex Test center index
+     * @return True if this filled the center
+     */
+    bool takeCenterUnit(int centerIndex) {
+        if (--testCenterCapacity[centerIndex] > 0) return false;
+        centerFull[centerIndex] = 1;
+        centerPenalty[centerIndex] = std::numeric_limits<float>::infinity();
+        return true;
+    }
+
+    void setRemainingCapacity(int centerIndex, int remaining) {
+        testCenterCapacity[centerIndex] = remaining;
+        centerFull[centerIndex] = remaining <= 0;
+        centerPenalty[centerIndex] = remaining <= 0 ? std::numeric_limits<float>::infinity() : 0.0f;
+    }
+
+    /**
+     * Clear the statistics and sketches
+     * @param capacities Initial capacity per center (utilization denominators)
+     */
+    void resetAssignmentStats(const std::vector<int>& capacities) const {
+        statsStale = false;
+        assignmentStats = AssignmentStats();
+        distribution = AssignmentDistribution(capacities);
+    }
+
+    /**
+     * Add one assignment to the running statistics
+     * @param result Assignment result
+     */
+    void accumulateAssignmentStats(const AssignmentResult& result) {
+        distribution.add(result.centerIndex, result.distance, result.category);
+        assignmentStats.totalAssigned++;
+    }
+
+    /**
+     * Fill assignmentStats from the sketches
+     */
+    void finishAssignmentStats() const {
+        const DistanceSketch& overall = distribution.getOverall();
+        const RunningStats& running = overall.getRunning();
+        
+        assignmentStats = AssignmentStats();
+        assignmentStats.totalAssigned = static_cast<int>(overall.getCount());
+        
+        // Count by category
+        for (const auto& entry : distribution.getByCategory()) {
+            int count = static_cast<int>(entry.second.getCount());
+            if (entry.first == "pwd") {
+                assignmentStats.pwdAssigned = count;
+            } else if (entry.first == "female") {
+                assignmentStats.femaleAssigned = count;
+            } else if (entry.first == "male") {
+                assignmentStats.maleAssigned = count;
+            }
+        }
+        
+        if (running.getCount() > 0) {
+            assignmentStats.averageDistance = running.getMean();
+            assignmentStats.maxDistance = running.getMax();
+            assignmentStats.minDistance = running.getMin();
+            assignmentStats.distanceStdDev = running.getStdDev();
+            assignmentStats.p50Distance = overall.quantile(0.50);
+            assignmentStats.p90Distance = overall.quantile(0.90);
+            assignmentStats.p99Distance = overall.quantile(0.99);
+        }
+    }
+
+    /**
+     * Reset assignments, slots and center capacities for a full run
+     * @param people People in matrix row order
+     * @param testCenters Test centers
+     * @param schedule Slots and slot capacities of every center
+     */
+    void beginRun(const std::vector<Point>& people, const std::vector<Point>& testCenters, const SlotSchedule& schedule) {
+        if (schedule.getCenterCount() != testCenters.size()) {
+            throw std::runtime_error("Slot schedule covers " + std::to_string(schedule.getCenterCount()) +
+                                     " centers, expected " + std::to_string(testCenters.size()));
+        }
+        
+        // Reset assignments
+        assignments.assign(people.size(), -1);
+        assignedSlot.assign(people.size(), -1);
+        slotSchedule = schedule;
+        slotSchedule.reset();
+        
+        // Initialize test center capacities
+        resetCenterState(slotSchedule.getCenterCapacities());
+    }
+
+    /**
+     * Hand out slots, compute statistics and seed incremental updates
+     * @param people People in matrix row order
+     * @param testCenters Test centers
+     * @param assignmentResults Results of the run (slotIndex set in place)
+     */
+    void finishRun(const std::vector<Point>& people, const std::vector<Point>& testCenters,
+                   std::vector<AssignmentResult>& assignmentResults) {
+        assignSlots(assignmentResults);
+        if (slotSchedule.getTotalSlotCount() > static_cast<int>(testCenters.size())) {
+            auto slotStats = slotSchedule.getSlotStats();
+            if (verbose) {
+                std::cout << "Slots: " << slotStats["used"] << "/" << slotStats["capacity"] << " units in "
+                          << slotStats["slots"] << " slots (" << slotStats["full_slots"] << " full)" << std::endl;
+            }
+        }
+        
+        // Calculate statistics
+        calculateAssignmentStats(assignmentResults);
+        
+        if (useIncrementalUpdates) {
+            seedIncrementalAssignment(people, testCenters, slotSchedule.getCenterCapacities(), assignmentResults);
+        } else {
+            incremental.reset();
+        }
+    }
+
+    /**
+     * Give every assigned person the earliest slot with room at their center,
+     * in result (priority) order
+     * @param results Assignment results, slotIndex set in place
+     */
+    void assignSlots(std::vector<AssignmentResult>& results) {
+        for (auto& result : results) {
+            result.slotIndex = slotSchedule.takeSlot(result.centerIndex);
+            assignedSlot[result.personIndex] = result.slotIndex;
+        }
+    }
+
+    /**
+     * Load the result of a full run into the incremental repairer
+     * @param people People in matrix row order
+     * @param testCenters Test centers
+     * @param capacities Capacity of every center
+     * @param assignmentResults Result of the full run
+     */
+    void seedIncrementalAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters, 
+        const std::vector<int>& capacities,
+        const std::vector<AssignmentResult>& assignmentResults) {
+        
+        std::vector<int> centerOf(people.size(), -1);
+        std::vector<double> distanceOf(people.size(), 0.0);
+        for (const auto& result : assignmentResults) {
+            centerOf[result.personIndex] = result.centerIndex;
+            distanceOf[result.personIndex] = result.distance;
+        }
+        
+        incremental.reset(new IncrementalAssignment(
+            testCenters, capacities,
+            [this](const Point& a, const Point& b) {
+                return exactDistance(a, b);
+            },
+            candidateCount > 0 ? candidateCount : static_cast<int>(NEAREST_LIST_SIZE), PRIORITY_TIERS));
+        
+        for (size_t i = 0; i < people.size(); i++) {
+            incremental->seedPerson(people[i], priorityTier(people[i].category), centerOf[i], distanceOf[i]);
+        }
+    }
+
+    /**
+     * Improve a greedy result in place by local search and report the gain
+     * @param people People in matrix row order
+     * @param testCenters Test centers
+     * @param results Assignment results, updated in place
+     * @param distanceOf Distance of any (person, center) pair
+     */
+    void improveAssignment(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters, 
+        std::vector<AssignmentResult>& results,
+        LocalSearchImprover::DistanceLookup distanceOf) {
+        
+        std::vector<int> tiers(people.size());
+        std::vector<int> centerOf(people.size(), -1);
+        std::vector<double> distanceOfAssigned(people.size(), 0.0);
+        std::vector<int> capacities(testCenterCapacity);
+        for (size_t i = 0; i < people.size(); i++) {
+            tiers[i] = priorityTier(people[i].category);
+        }
+        for (const auto& result : results) {
+            centerOf[result.personIndex] = result.centerIndex;
+            distanceOfAssigned[result.personIndex] = result.distance;
+        }
+        
+        LocalSearchImprover improver(people, testCenters, tiers, centerOf, distanceOfAssigned, capacities,
+                                     distanceOf, localSearchObjective);
+        improver.setThreadCount(localSearchThreads);
+        improver.improve(localSearchBudget);
+        
+        for (auto& result : results) {
+            result.centerIndex = improver.getAssignedCenter(result.personIndex);
+            result.center = testCenters[result.centerIndex];
+            result.distance = improver.getAssignedDistance(result.personIndex);
+            assignments[result.personIndex] = result.centerIndex;
+        }
+        for (size_t j = 0; j < testCenters.size(); j++) {
+            setRemainingCapacity(j, improver.getRemainingCapacity()[j]);
+        }
+        
+        auto improvement = improver.getImprovementStats();
+        if (verbose) {
+            std::cout << "Local search: total " << improvement["initial_total_km"] << " -> "
+                      << improvement["final_total_km"] << " km, max " << improvement["initial_max_km"] << " -> "
+                      << improvement["final_max_km"] << " km (" << improvement["relocates"] << " relocates, "
+                      << improvement["swaps"] << " swaps, " << improvement["ejections"] << " ejections in "
+                      << improvement["rounds"] << " rounds, " << improvement["elapsed_ms"] << " ms on "
+                      << improvement["threads"] << " threads)" << std::endl;
+        }
+    }
+
+    void requireIncremental() const {
+        if (!incremental) {
+            throw std::runtime_error("Incremental updates need setIncrementalUpdatesEnabled(true) "
+                                     "before assignPeopleToTestCenters");
+        }
+    }
+
+    void requireCenter(int centerIndex) const {
+        if (centerIndex < 0 || centerIndex >= static_cast<int>(centerFull.size())) {
+            throw std::runtime_error("Unknown test center " + std::to_string(centerIndex));
+        }
+    }
+
+    /**
+     * Mirror the people changed by the last update into the assignments,
+     * slots and center capacities
+     */
+    void applyIncrementalChanges() {
+        assignments.resize(incremental->getPersonCount(), -1);
+        assignedSlot.resize(incremental->getPersonCount(), -1);
+        const std::vector<int>& changed = incremental->getChangedPeople();
+        statsStale = statsStale || !changed.empty();
+        
+        // Free the old slots first so the new placements can reuse them
+        for (int personIndex : changed) {
+            if (assignedSlot[personIndex] != -1) {
+                slotSchedule.releaseSlot(assignments[personIndex], assignedSlot[personIndex]);
+                assignedSlot[personIndex] = -1;
+            }
+        }
+        
+        for (int personIndex : changed) {
+            if (assignments[personIndex] != -1) {
+                refreshCenter(assignments[personIndex]);
+            }
+            
+            assignments[personIndex] = incremental->getAssignedCenter(personIndex);
+            if (assignments[personIndex] != -1) {
+                refreshCenter(assignments[personIndex]);
+                if (assignedSlot[personIndex] == -1) {
+                    assignedSlot[personIndex] = slotSchedule.takeSlot(assignments[personIndex]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Rebuild the statistics from the repaired assignment if incremental
+     * updates changed it since they were built. The sketches cannot drop a
+     * sample, so updates only mark them stale and the next read pays one
+     * pass over the people.
+     */
+    void refreshIncrementalStats() const {
+        if (!statsStale || !incremental) return;
+        resetAssignmentStats(slotSchedule.getCenterCapacities());
+        for (size_t i = 0; i < incremental->getPersonCount(); i++) {
+            int personIndex = static_cast<int>(i);
+            int centerIndex = incremental->getAssignedCenter(personIndex);
+            if (centerIndex == -1) continue;
+            distribution.add(centerIndex, incremental->getAssignedDistance(personIndex),
+                             incremental->getPerson(personIndex).category);
+        }
+        finishAssignmentStats();
+    }
+
+    void refreshCenter(int centerIndex) {
+        setRemainingCapacity(centerIndex, incremental->getRemainingCapacity(centerIndex));
+    }
+
+    /**
+     * Solve tier by tier on top of the previous tiers and record the result
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order, grouped by tier
+     * @param testCenters Test centers
+     * @param solver MinCostFlowAssignment or AuctionAssignment
+     * @return Assignment results
+     */
+    template <typename TierSolver>
+    std::vector<AssignmentResult> assignByTier(
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
+        const std::vector<Point>& testCenters, 
+        TierSolver& solver) {
+        
+        size_t tierBegin = 0;
+        while (tierBegin < priorityOrder.size()) {
+            int tier = priorityTier(people[priorityOrder[tierBegin]].category);
+            size_t tierEnd = tierBegin;
+            while (tierEnd < priorityOrder.size() && priorityTier(people[priorityOrder[tierEnd]].category) == tier) {
+                tierEnd++;
+            }
+            
+            std::vector<int> tierPeople(priorityOrder.begin() + tierBegin, priorityOrder.begin() + tierEnd);
+            solver.assignTier(tierPeople);
+            tierBegin = tierEnd;
+        }
+        
+        std::vector<AssignmentResult> results;
+        for (int personIndex : priorityOrder) {
+            int centerIndex = solver.getAssignedCenter(personIndex);
+            if (centerIndex == -1) continue;
+            
+            assignments[personIndex] = centerIndex;
+            takeCenterUnit(centerIndex);
+            results.emplace_back(personIndex, centerIndex, people[personIndex], testCenters[centerIndex],
+                                 solver.getAssignedDistance(personIndex), people[personIndex].category);
+        }
+        
+        return results;
+    }
+
+    /**
+     * Greedy assignment loop shared by the dense, lazy and sparse matrix paths
+     * @param people People in matrix row order
+     * @param priorityOrder Person indices in assignment order
+     * @param testCenters Test centers
+     * @param findCenter Returns (centerIndex, distance) for a person index, or (-1, -1)
+     * @return Assignment results
+     */
+    std::vector<AssignmentResult> assignInPriorityOrder(
+        const std::vector<Point>& people, 
+        const std::vector<int>& priorityOrder, 
+        const std::vector<Point>& testCenters, 
+        const std::function<std::pair<int, double>(int)>& findCenter) {
+        
+        std::vector<AssignmentResult> results;
+        
+        for (int personIndex : priorityOrder) {
+            const Point& person = people[personIndex];
+            
+            // Find best available test center for this person
+            auto bestAssignment = findCenter(personIndex);
+            
+            if (bestAssignment.first != -1) {
+                int centerIndex = bestAssignment.first;
+                double distance = bestAssignment.second;
+                
+                // Make assignment
+                assignments[personIndex] = centerIndex;
+                takeCenterUnit(centerIndex);
+                
+                results.emplace_back(personIndex, centerIndex, person, 
+                                   testCenters[centerIndex], distance, person.category);
+            }
+        }
+        
+        return results;
+    }
 };
 
 #endif // ASSIGNMENT_ALGORITHM_H
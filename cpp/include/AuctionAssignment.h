@@ -0,0 +1,465 @@
+#ifndef AUCTION_ASSIGNMENT_H
+#define AUCTION_ASSIGNMENT_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include "TieredAssignmentBase.h"
+
+/**
+ * Capacitated assignment over candidate (person, center) arcs by the
+ * Bertsekas auction algorithm with epsilon scaling.
+ *
+ * A center of capacity c is treated as c similar objects ("copies"), kept
+ * in a min-heap by price so a bidder always takes the cheapest copy and the
+ * second cheapest copy is at hand for the bid increment. A dummy object of
+ * unlimited capacity stands for "unassigned"; it costs more than any simple
+ * path through real centers, so coverage is maximized before distance.
+ *
+ * Forward bidding is Jacobi style: all unassigned people of a round compute
+ * their bids in parallel against the same prices, then the bids are resolved
+ * in order. A bid only wins if it still beats the current price of the
+ * cheapest copy, which keeps every holder epsilon-happy.
+ *
+ * There are usually more copies than people, and a copy left free with a
+ * price would spoil optimality. After every phase a reverse auction lowers
+ * such prices just far enough for the most interested person to take the
+ * copy (releasing the one it held), until every free copy is at price zero.
+ * The final phase then leaves an optimal assignment for the candidate arcs
+ * (costs are integer meters scaled by people + 1, final epsilon 1).
+ *
+ * Like MinCostFlowAssignment, tiers are solved and frozen one at a time, and
+ * people of a tier left unassigned while capacity is free get their
+ * candidate lists extended before the tier is bid again.
+ */
+class AuctionAssignment : public TieredAssignmentBase {
+private:
+    static constexpr int64_t SCALING_FACTOR = 5;           // Epsilon divisor per phase
+    static constexpr size_t PARALLEL_BID_THRESHOLD = 2048; // Fewer bidders bid serially
+
+    int threadCount;
+
+    // Tier being solved; people are local indices [0, m), the dummy is center C
+    std::vector<int> tierPeople;
+    int dummyCenter;
+    int64_t unassignedCost;
+    std::vector<size_t> firstArc;         // Person -> candidate center arcs, CSR
+    std::vector<int> arcCenter;
+    std::vector<int64_t> arcCost;         // Scaled meters
+    std::vector<size_t> firstCenterArc;   // Center -> person arcs, CSR
+    std::vector<int> centerArcPerson;
+    std::vector<int64_t> centerArcCost;
+    std::vector<size_t> firstCopy;        // Copies per center, each range a min-heap
+    std::vector<int64_t> copyPrice;
+    std::vector<int> copyHolder;          // Local person or -1
+
+    std::vector<int> heldCenter;          // Center, dummy or -1 while bidding
+    std::vector<int64_t> heldCost;
+    std::vector<int64_t> heldPrice;
+    std::vector<int> bidCenter;
+    std::vector<int64_t> bidCost;
+    std::vector<int64_t> bidPrice;
+
+    long long phases;
+    long long rounds;
+    long long parallelRounds;
+    long long bids;
+    long long reverseBids;
+
+public:
+    /**
+     * @param people Number of people
+     * @param capacities Remaining capacity of each center
+     * @param candidates Candidate centers of a person (distances in km)
+     * @param extender Adds more candidates for a person, false once exhausted (optional)
+     */
+    AuctionAssignment(size_t people, const std::vector<int>& capacities,
+                      CandidateList candidates, CandidateExtender extender = nullptr)
+        : TieredAssignmentBase(people, capacities, candidates, extender)
+        , threadCount(std::max(1u, std::thread::hardware_concurrency()))
+        , dummyCenter(0)
+        , unassignedCost(0)
+        , phases(0)
+        , rounds(0)
+        , parallelRounds(0)
+        , bids(0)
+        , reverseBids(0) {}
+
+    /**
+     * Set number of threads computing bids
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void setThreadCount(int threads) {
+        threadCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int getThreadCount() const {
+        return threadCount;
+    }
+
+    /**
+     * Assign one priority tier on top of the frozen earlier tiers
+     * @param people Person indices of the tier
+     * @return Number of people of the tier assigned
+     */
+    int assignTier(const std::vector<int>& people) {
+        if (people.empty()) return 0;
+
+        tierPeople = people;
+        int personNodes = static_cast<int>(tierPeople.size());
+        dummyCenter = static_cast<int>(remainingCapacity.size());
+        buildArcs();
+        buildCopies();
+        heldCenter.assign(personNodes, -1);
+        heldCost.assign(personNodes, 0);
+        heldPrice.assign(personNodes, 0);
+        bidCenter.assign(personNodes, -1);
+        bidCost.assign(personNodes, 0);
+        bidPrice.assign(personNodes, 0);
+
+        std::vector<int> everyone(personNodes);
+        for (int i = 0; i < personNodes; i++) {
+            everyone[i] = i;
+        }
+
+        int round = 0;
+        while (true) {
+            // Epsilon scaling: every phase restarts bidding from the previous prices
+            int64_t epsilon = std::max<int64_t>(unassignedCost / SCALING_FACTOR, 1);
+            while (true) {
+                std::fill(copyHolder.begin(), copyHolder.end(), -1);
+                std::fill(heldCenter.begin(), heldCenter.end(), -1);
+                runAuction(everyone, epsilon);
+                reverseAuction(epsilon);
+                phases++;
+                if (epsilon == 1) break;
+                epsilon = std::max<int64_t>(epsilon / SCALING_FACTOR, 1);
+            }
+            if (!hasFreeCopy() || !extendUnassigned(tierPeople, [&](size_t i) {
+                    return heldCenter[i] == dummyCenter;
+                }, round)) {
+                break;
+            }
+            buildArcs();
+        }
+
+        // Read back and freeze the tier's assignments
+        for (int i = 0; i < personNodes; i++) {
+            int personIndex = tierPeople[i];
+            assignedCenter[personIndex] = -1;
+            assignedDistance[personIndex] = 0.0;
+            if (heldCenter[i] == dummyCenter) continue;
+
+            for (const DistanceCandidate& candidate : candidatesOf(personIndex)) {
+                if (candidate.centerIndex == heldCenter[i] && isReachable(candidate)) {
+                    assignedCenter[personIndex] = candidate.centerIndex;
+                    assignedDistance[personIndex] = candidate.distance;
+                    break;
+                }
+            }
+        }
+        return freezeTier(tierPeople);
+    }
+
+    /**
+     * Get solver statistics
+     * @return Phase, round, bid and extension counters
+     */
+    std::map<std::string, long long> getSolverStats() const {
+        std::map<std::string, long long> stats;
+        stats["phases"] = phases;
+        stats["rounds"] = rounds;
+        stats["parallel_rounds"] = parallelRounds;
+        stats["bids"] = bids;
+        stats["reverse_bids"] = reverseBids;
+        stats["extension_rounds"] = extensionRounds;
+        stats["threads"] = threadCount;
+        return stats;
+    }
+
+private:
+    /**
+     * Copy the tier's candidate arcs with scaled integer costs, in both directions
+     */
+    void buildArcs() {
+        int personNodes = static_cast<int>(tierPeople.size());
+        int64_t scale = personNodes + 1;
+
+        firstArc.assign(personNodes + 1, 0);
+        arcCenter.clear();
+        arcCost.clear();
+        firstCenterArc.assign(dummyCenter + 1, 0);
+        for (int i = 0; i < personNodes; i++) {
+            for (const DistanceCandidate& candidate : candidatesOf(tierPeople[i])) {
+                if (remainingCapacity[candidate.centerIndex] == 0 || !isReachable(candidate)) continue;
+                arcCenter.push_back(candidate.centerIndex);
+                arcCost.push_back(toMeters(candidate.distance) * scale);
+                firstCenterArc[candidate.centerIndex + 1]++;
+            }
+            firstArc[i + 1] = arcCenter.size();
+        }
+
+        for (int j = 0; j < dummyCenter; j++) {
+            firstCenterArc[j + 1] += firstCenterArc[j];
+        }
+        centerArcPerson.resize(arcCenter.size());
+        centerArcCost.resize(arcCenter.size());
+        std::vector<size_t> nextArc(firstCenterArc.begin(), firstCenterArc.end() - 1);
+        for (int i = 0; i < personNodes; i++) {
+            for (size_t arc = firstArc[i]; arc < firstArc[i + 1]; arc++) {
+                size_t slot = nextArc[arcCenter[arc]]++;
+                centerArcPerson[slot] = i;
+                centerArcCost[slot] = arcCost[arc];
+            }
+        }
+
+        // Must exceed any simple path through centers. It is bounded by the
+        // largest possible arc rather than the loaded ones, so extending
+        // candidate lists never moves it and the prices reached stay valid
+        unassignedCost = (static_cast<int64_t>(dummyCenter) + 2) * MAX_ARC_COST * scale;
+    }
+
+    void buildCopies() {
+        firstCopy.assign(dummyCenter + 1, 0);
+        for (int j = 0; j < dummyCenter; j++) {
+            firstCopy[j + 1] = firstCopy[j] + remainingCapacity[j];
+        }
+        copyPrice.assign(firstCopy[dummyCenter], 0);
+        copyHolder.assign(firstCopy[dummyCenter], -1);
+    }
+
+    bool hasFreeCopy() const {
+        return std::find(copyHolder.begin(), copyHolder.end(), -1) != copyHolder.end();
+    }
+
+    /**
+     * Value of what a person holds: minus its cost and price
+     */
+    int64_t heldValue(int person) const {
+        return heldCenter[person] == dummyCenter ? -unassignedCost : -heldCost[person] - heldPrice[person];
+    }
+
+    int64_t secondCheapestCopy(int center) const {
+        size_t base = firstCopy[center];
+        size_t size = firstCopy[center + 1] - base;
+        if (size < 2) return -1;
+        if (size == 2) return copyPrice[base + 1];
+        return std::min(copyPrice[base + 1], copyPrice[base + 2]);
+    }
+
+    void swapCopies(size_t a, size_t b) {
+        std::swap(copyPrice[a], copyPrice[b]);
+        std::swap(copyHolder[a], copyHolder[b]);
+    }
+
+    void siftDown(int center, size_t position) {
+        size_t base = firstCopy[center];
+        size_t size = firstCopy[center + 1] - base;
+        while (true) {
+            size_t smallest = position;
+            size_t left = 2 * position + 1;
+            size_t right = left + 1;
+            if (left < size && copyPrice[base + left] < copyPrice[base + smallest]) smallest = left;
+            if (right < size && copyPrice[base + right] < copyPrice[base + smallest]) smallest = right;
+            if (smallest == position) break;
+            swapCopies(base + position, base + smallest);
+            position = smallest;
+        }
+    }
+
+    void siftUp(int center, size_t position) {
+        size_t base = firstCopy[center];
+        while (position > 0) {
+            size_t parent = (position - 1) / 2;
+            if (copyPrice[base + parent] <= copyPrice[base + position]) break;
+            swapCopies(base + parent, base + position);
+            position = parent;
+        }
+    }
+
+    /**
+     * Compute the bid of one person against the current prices
+     */
+    void computeBid(int person, int64_t epsilon) {
+        int64_t bestValue = -unassignedCost;
+        int64_t secondValue = -unassignedCost; // The dummy has unlimited copies
+        int bestCenter = dummyCenter;
+        int64_t bestCost = 0;
+
+        for (size_t arc = firstArc[person]; arc < firstArc[person + 1]; arc++) {
+            int center = arcCenter[arc];
+            int64_t value = -arcCost[arc] - copyPrice[firstCopy[center]];
+            if (value > bestValue) {
+                secondValue = bestValue;
+                bestValue = value;
+                bestCenter = center;
+                bestCost = arcCost[arc];
+            } else if (value > secondValue) {
+                secondValue = value;
+            }
+        }
+
+        bidCenter[person] = bestCenter;
+        if (bestCenter == dummyCenter) return;
+
+        int64_t secondCopy = secondCheapestCopy(bestCenter);
+        if (secondCopy >= 0) {
+            secondValue = std::max(secondValue, -bestCost - secondCopy);
+        }
+        bidCost[person] = bestCost;
+        bidPrice[person] = -bestCost - secondValue + epsilon;
+    }
+
+    void computeBids(const std::vector<int>& bidders, int64_t epsilon) {
+        int threads = std::min<int>(threadCount, static_cast<int>(bidders.size() / (PARALLEL_BID_THRESHOLD / 2)));
+        if (bidders.size() < PARALLEL_BID_THRESHOLD || threads < 2) {
+            for (int person : bidders) {
+                computeBid(person, epsilon);
+            }
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        size_t chunk = (bidders.size() + threads - 1) / threads;
+        for (int t = 0; t < threads; t++) {
+            size_t begin = t * chunk;
+            size_t end = std::min(begin + chunk, bidders.size());
+            workers.emplace_back([this, &bidders, begin, end, epsilon]() {
+                for (size_t b = begin; b < end; b++) {
+                    computeBid(bidders[b], epsilon);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        parallelRounds++;
+    }
+
+    /**
+     * Forward auction: bid in Jacobi rounds until every bidder holds a copy
+     * or the dummy
+     */
+    void runAuction(std::vector<int> bidders, int64_t epsilon) {
+        std::vector<int> nextBidders;
+        while (!bidders.empty()) {
+            computeBids(bidders, epsilon);
+            rounds++;
+            bids += bidders.size();
+
+            nextBidders.clear();
+            for (int person : bidders) {
+                int center = bidCenter[person];
+                if (center == dummyCenter) {
+                    heldCenter[person] = dummyCenter;
+                    continue;
+                }
+
+                size_t root = firstCopy[center];
+                if (bidPrice[person] <= copyPrice[root]) {
+                    // Outbid earlier in this round; try again at the new prices
+                    nextBidders.push_back(person);
+                    continue;
+                }
+
+                int evicted = copyHolder[root];
+                if (evicted != -1) {
+                    heldCenter[evicted] = -1;
+                    nextBidders.push_back(evicted);
+                }
+                copyPrice[root] = bidPrice[person];
+                copyHolder[root] = person;
+                heldCenter[person] = center;
+                heldCost[person] = bidCost[person];
+                heldPrice[person] = bidPrice[person];
+                siftDown(center, 0);
+            }
+            bidders.swap(nextBidders);
+        }
+    }
+
+    /**
+     * Reverse auction: a free copy with a price lowers it to just below what
+     * the second most interested person would pay and goes to the most
+     * interested one, whose previous copy becomes free in turn. A copy nobody
+     * wants by at least epsilon drops to price zero.
+     */
+    void reverseAuction(int64_t epsilon) {
+        std::vector<int> pending;
+        std::vector<char> queued(dummyCenter, 1);
+        for (int j = dummyCenter - 1; j >= 0; j--) {
+            pending.push_back(j);
+        }
+
+        while (!pending.empty()) {
+            int center = pending.back();
+            pending.pop_back();
+            queued[center] = 0;
+
+            size_t base = firstCopy[center];
+            size_t copy = base;
+            while (copy < firstCopy[center + 1]) {
+                if (copyHolder[copy] != -1 || copyPrice[copy] == 0) {
+                    copy++;
+                    continue;
+                }
+
+                int64_t bestGain = std::numeric_limits<int64_t>::min();
+                int64_t secondGain = std::numeric_limits<int64_t>::min();
+                int bestPerson = -1;
+                int64_t bestCost = 0;
+                for (size_t arc = firstCenterArc[center]; arc < firstCenterArc[center + 1]; arc++) {
+                    int person = centerArcPerson[arc];
+                    int64_t gain = -centerArcCost[arc] - heldValue(person);
+                    if (gain > bestGain) {
+                        secondGain = bestGain;
+                        bestGain = gain;
+                        bestPerson = person;
+                        bestCost = centerArcCost[arc];
+                    } else if (gain > secondGain) {
+                        secondGain = gain;
+                    }
+                }
+                reverseBids++;
+
+                if (bestPerson == -1 || bestGain < epsilon) {
+                    copyPrice[copy] = 0;
+                } else {
+                    int previous = heldCenter[bestPerson];
+                    if (previous != dummyCenter) {
+                        for (size_t held = firstCopy[previous]; held < firstCopy[previous + 1]; held++) {
+                            if (copyHolder[held] == bestPerson) {
+                                copyHolder[held] = -1;
+                                break;
+                            }
+                        }
+                        if (!queued[previous]) {
+                            pending.push_back(previous);
+                            queued[previous] = 1;
+                        }
+                    }
+
+                    int64_t price = secondGain == std::numeric_limits<int64_t>::min() ?
+                        0 : std::max<int64_t>(secondGain - epsilon, 0);
+                    copyPrice[copy] = std::min(copyPrice[copy], price);
+                    copyHolder[copy] = bestPerson;
+                    heldCenter[bestPerson] = center;
+                    heldCost[bestPerson] = bestCost;
+                    heldPrice[bestPerson] = copyPrice[copy];
+                }
+
+                // A lowered price may move the copy up the heap; rescan the center
+                siftUp(center, copy - base);
+                copy = base;
+            }
+        }
+    }
+};
+
+#endif // AUCTION_ASSIGNMENT_H
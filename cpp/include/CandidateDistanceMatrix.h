@@ -0,0 +1,153 @@
+#ifndef CANDIDATE_DISTANCE_MATRIX_H
+#define CANDIDATE_DISTANCE_MATRIX_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include "CenterSpatialIndex.h"
+
+struct DistanceCandidate {
+    int centerIndex;
+    double distance;
+
+    DistanceCandidate(int c = -1, double d = 0.0) : centerIndex(c), distance(d) {}
+};
+
+/**
+ * Sparse distance matrix keeping only the k nearest centers per person.
+ *
+ * Candidates are picked by Haversine distance (a lower bound on road
+ * distance) through a spatial index, and exact distances are computed only
+ * for those. When every candidate of a person is full, the list is extended
+ * by another k centers; this is the only time more pairs are evaluated.
+ * Memory and distance queries are O(P * k) instead of O(P * C).
+ */
+class CandidateDistanceMatrix {
+private:
+    const std::vector<Point>& people;
+    const std::vector<Point>& testCenters;
+    std::function<double(const Point&, const Point&)> exactDistance;
+    CenterSpatialIndex spatialIndex;
+    int candidateCount;
+    std::vector<std::vector<DistanceCandidate>> candidates; // Sorted by exact distance
+    std::vector<int> fetchedCount; // Nearest centers fetched so far per person
+    long long evaluatedPairs;
+    long long overflowExtensions;
+
+public:
+    /**
+     * Build candidate lists for all people
+     * @param p People (must outlive the matrix)
+     * @param c Test centers (must outlive the matrix)
+     * @param k Candidates per person
+     * @param exactFn Exact (road) distance function
+     */
+    CandidateDistanceMatrix(const std::vector<Point>& p, const std::vector<Point>& c, int k,
+                            std::function<double(const Point&, const Point&)> exactFn)
+        : people(p)
+        , testCenters(c)
+        , exactDistance(exactFn)
+        , spatialIndex(c)
+        , candidateCount(std::max(k, 1))
+        , candidates(p.size())
+        , fetchedCount(p.size(), 0)
+        , evaluatedPairs(0)
+        , overflowExtensions(0) {
+
+        for (size_t i = 0; i < people.size(); i++) {
+            extendCandidates(i);
+        }
+    }
+
+    /**
+     * Find the nearest available candidate center, extending the candidate
+     * list only when all current candidates are full
+     * @param personIndex Person index
+     * @param isAvailable Predicate telling whether a center still has capacity
+     * @return Pair of (centerIndex, distance) or (-1, -1) if none available
+     */
+    std::pair<int, double> findBestAvailable(int personIndex, const std::function<bool(int)>& isAvailable) {
+        size_t checked = 0;
+
+        while (true) {
+            const std::vector<DistanceCandidate>& list = candidates[personIndex];
+            for (; checked < list.size(); checked++) {
+                if (isAvailable(list[checked].centerIndex)) {
+                    return std::make_pair(list[checked].centerIndex, list[checked].distance);
+                }
+            }
+
+            if (fetchedCount[personIndex] >= static_cast<int>(testCenters.size())) {
+                return std::make_pair(-1, -1.0);
+            }
+
+            overflowExtensions++;
+            extendCandidates(personIndex);
+            // Newly added candidates may sort before checked ones, but those were all full
+            checked = 0;
+        }
+    }
+
+    /**
+     * Add the next k nearest centers to a person's candidate list
+     * @param personIndex Person index
+     * @return False if the list already holds every center
+     */
+    bool extendCandidateList(int personIndex) {
+        if (fetchedCount[personIndex] >= static_cast<int>(testCenters.size())) {
+            return false;
+        }
+        overflowExtensions++;
+        extendCandidates(personIndex);
+        return true;
+    }
+
+    /**
+     * Get candidate list of a person
+     * @param personIndex Person index
+     * @return Candidates sorted by ascending distance
+     */
+    const std::vector<DistanceCandidate>& getCandidates(int personIndex) const {
+        return candidates[personIndex];
+    }
+
+    /**
+     * Get evaluation statistics
+     * @return Evaluated, stored and total pair counts
+     */
+    std::map<std::string, long long> getEvaluationStats() const {
+        std::map<std::string, long long> stats;
+        stats["evaluated_pairs"] = evaluatedPairs;
+        stats["total_pairs"] = static_cast<long long>(people.size()) * testCenters.size();
+        stats["candidates_per_person"] = candidateCount;
+        stats["overflow_extensions"] = overflowExtensions;
+        return stats;
+    }
+
+private:
+    /**
+     * Fetch the next k nearest centers for a person and evaluate their exact distances
+     * @param personIndex Person index
+     */
+    void extendCandidates(int personIndex) {
+        int previous = fetchedCount[personIndex];
+        int target = std::min(previous + candidateCount, static_cast<int>(testCenters.size()));
+        std::vector<int> nearest = spatialIndex.findNearest(people[personIndex], target);
+
+        std::vector<DistanceCandidate>& list = candidates[personIndex];
+        for (size_t i = previous; i < nearest.size(); i++) {
+            int centerIndex = nearest[i];
+            list.emplace_back(centerIndex, exactDistance(people[personIndex], testCenters[centerIndex]));
+            evaluatedPairs++;
+        }
+
+        std::sort(list.begin(), list.end(), [](const DistanceCandidate& a, const DistanceCandidate& b) {
+            return a.distance < b.distance;
+        });
+        fetchedCount[personIndex] = target;
+    }
+};
+
+#endif // CANDIDATE_DISTANCE_MATRIX_H
@@ -0,0 +1,144 @@
+#ifndef CENTER_SPATIAL_INDEX_H
+#define CENTER_SPATIAL_INDEX_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "RandomPointGenerator.h"
+
+/**
+ * Uniform lat/lng grid over test centers answering k-nearest queries by
+ * Haversine distance. Cells are visited in rings around the query point and
+ * the search stops once no unvisited ring can contain a closer center.
+ */
+class CenterSpatialIndex {
+private:
+    static constexpr double KM_PER_DEGREE = 111.19;
+
+    std::vector<Point> centers;
+    double minLat, minLng;
+    double cellSize; // Cell size in degrees
+    int rows, cols;
+    double maxAbsLat;
+    std::vector<std::vector<int>> cells;
+
+public:
+    /**
+     * Build index over test centers
+     * @param testCenters Test centers
+     * @param cellSizeDegrees Grid cell size in degrees (0 picks about one center per cell)
+     */
+    CenterSpatialIndex(const std::vector<Point>& testCenters, double cellSizeDegrees = 0.0)
+        : centers(testCenters), minLat(0), minLng(0), cellSize(1.0), rows(1), cols(1), maxAbsLat(0) {
+
+        if (centers.empty()) {
+            cells.resize(1);
+            return;
+        }
+
+        double maxLat = centers[0].latitude, maxLng = centers[0].longitude;
+        minLat = maxLat;
+        minLng = maxLng;
+        for (const Point& center : centers) {
+            minLat = std::min(minLat, center.latitude);
+            maxLat = std::max(maxLat, center.latitude);
+            minLng = std::min(minLng, center.longitude);
+            maxLng = std::max(maxLng, center.longitude);
+        }
+
+        double extent = std::max(maxLat - minLat, maxLng - minLng);
+        cellSize = cellSizeDegrees > 0 ? cellSizeDegrees :
+            std::max(extent / std::ceil(std::sqrt(static_cast<double>(centers.size()))), 1e-4);
+
+        rows = static_cast<int>((maxLat - minLat) / cellSize) + 1;
+        cols = static_cast<int>((maxLng - minLng) / cellSize) + 1;
+        cells.resize(static_cast<size_t>(rows) * cols);
+
+        for (size_t i = 0; i < centers.size(); i++) {
+            cells[cellIndex(cellRow(centers[i].latitude), cellCol(centers[i].longitude))].push_back(i);
+        }
+
+        maxAbsLat = std::max(std::abs(minLat), std::abs(maxLat));
+    }
+
+    /**
+     * Find the k nearest centers by Haversine distance
+     * @param point Query point
+     * @param k Number of centers to return
+     * @param filter Optional predicate; centers failing it are skipped
+     * @return Center indices sorted by ascending distance
+     */
+    std::vector<int> findNearest(const Point& point, int k,
+                                 const std::function<bool(int)>& filter = nullptr) const {
+        std::vector<std::pair<double, int>> found;
+        if (k <= 0 || centers.empty()) return {};
+
+        int row = cellRow(point.latitude);
+        int col = cellCol(point.longitude);
+        int maxRing = std::max({row, rows - 1 - row, col, cols - 1 - col});
+        double ringKm = cellSize * minKmPerDegree(point);
+
+        for (int ring = 0; ring <= maxRing; ring++) {
+            // Every cell in this ring is at least (ring - 1) whole cells away
+            if (static_cast<int>(found.size()) >= k) {
+                std::nth_element(found.begin(), found.begin() + (k - 1), found.end());
+                if ((ring - 1) * ringKm > found[k - 1].first) break;
+            }
+
+            for (int r = row - ring; r <= row + ring; r++) {
+                if (r < 0 || r >= rows) continue;
+                bool edgeRow = (r == row - ring || r == row + ring);
+                int step = edgeRow ? 1 : 2 * ring;
+                for (int c = col - ring; c <= col + ring; c += std::max(step, 1)) {
+                    if (c < 0 || c >= cols) continue;
+                    for (int centerIndex : cells[cellIndex(r, c)]) {
+                        if (filter && !filter(centerIndex)) continue;
+                        found.push_back({point.distanceTo(centers[centerIndex]), centerIndex});
+                    }
+                }
+            }
+        }
+
+        std::sort(found.begin(), found.end());
+        if (static_cast<int>(found.size()) > k) found.resize(k);
+
+        std::vector<int> result;
+        result.reserve(found.size());
+        for (const auto& entry : found) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+
+    /**
+     * Get number of indexed centers
+     * @return Center count
+     */
+    size_t size() const {
+        return centers.size();
+    }
+
+private:
+    // Cell coordinates may lie outside the grid for query points beyond the indexed area
+    int cellRow(double latitude) const {
+        return static_cast<int>(std::floor((latitude - minLat) / cellSize));
+    }
+
+    int cellCol(double longitude) const {
+        return static_cast<int>(std::floor((longitude - minLng) / cellSize));
+    }
+
+    // Conservative km per degree in either axis; the 0.95 margin covers great-circle
+    // paths that bend poleward between points far apart in longitude
+    double minKmPerDegree(const Point& point) const {
+        double lat = std::min(std::max(maxAbsLat, std::abs(point.latitude)), 89.0);
+        return 0.95 * KM_PER_DEGREE * std::cos(lat * M_PI / 180.0);
+    }
+
+    size_t cellIndex(int row, int col) const {
+        return static_cast<size_t>(row) * cols + col;
+    }
+};
+
+#endif // CENTER_SPATIAL_INDEX_H
@@ -0,0 +1,148 @@
+#ifndef COORDINATE_SNAPPER_H
+#define COORDINATE_SNAPPER_H
+
+#include <vector>
+#include <cmath>
+#include <memory>
+#include <algorithm>
+#include <iostream>
+#include "CenterSpatialIndex.h"
+
+enum class SnapMode {
+    None,       // Use coordinates as given
+    Grid,       // Round to a fixed-precision grid
+    RoadVertex  // Move to the nearest road graph vertex
+};
+
+struct SnapStats {
+    long long snappedQueries;
+    double totalErrorBoundKm;
+    double maxErrorBoundKm;
+    double maxDisplacementKm;
+
+    SnapStats() : snappedQueries(0), totalErrorBoundKm(0), maxErrorBoundKm(0), maxDisplacementKm(0) {}
+
+    double averageErrorBoundKm() const {
+        return snappedQueries > 0 ? totalErrorBoundKm / snappedQueries : 0.0;
+    }
+};
+
+/**
+ * Snaps query coordinates before cache lookup and routing so that nearby
+ * points share cache entries.
+ *
+ * For a pair moved by d1 and d2, the triangle inequality bounds the change in
+ * distance by d1 + d2; that bound is accumulated per query as the induced
+ * distance error.
+ */
+class CoordinateSnapper {
+private:
+    static constexpr double METERS_PER_DEGREE = 111190.0;
+
+    SnapMode mode;
+    double gridMeters;
+    std::vector<Point> roadVertices;
+    std::shared_ptr<const CenterSpatialIndex> vertexIndex; // Read-only, shared by copies
+    SnapStats stats;
+
+public:
+    CoordinateSnapper() : mode(SnapMode::None), gridMeters(25.0) {}
+
+    /**
+     * Snap to a grid of the given spacing
+     * @param meters Grid spacing in meters
+     */
+    void useGrid(double meters) {
+        mode = SnapMode::Grid;
+        gridMeters = std::max(meters, 0.01);
+    }
+
+    /**
+     * Snap to the nearest road vertex
+     * @param vertices Road graph vertex locations
+     */
+    void useRoadVertices(const std::vector<Point>& vertices) {
+        mode = vertices.empty() ? SnapMode::None : SnapMode::RoadVertex;
+        roadVertices = vertices;
+        vertexIndex = std::make_shared<const CenterSpatialIndex>(roadVertices);
+    }
+
+    /**
+     * Disable snapping
+     */
+    void disable() {
+        mode = SnapMode::None;
+    }
+
+    SnapMode getMode() const {
+        return mode;
+    }
+
+    /**
+     * Snap a single point
+     * @param point Point to snap
+     * @return Snapped point (type and category preserved)
+     */
+    Point snap(const Point& point) const {
+        Point snapped = point;
+
+        if (mode == SnapMode::Grid) {
+            double latStep = gridMeters / METERS_PER_DEGREE;
+            snapped.latitude = std::round(point.latitude / latStep) * latStep;
+            // Longitude spacing depends on the snapped latitude so the grid is deterministic
+            double lngScale = std::max(std::cos(snapped.latitude * M_PI / 180.0), 1e-6);
+            double lngStep = latStep / lngScale;
+            snapped.longitude = std::round(point.longitude / lngStep) * lngStep;
+        } else if (mode == SnapMode::RoadVertex) {
+            std::vector<int> nearest = vertexIndex->findNearest(point, 1);
+            if (!nearest.empty()) {
+                snapped.latitude = roadVertices[nearest[0]].latitude;
+                snapped.longitude = roadVertices[nearest[0]].longitude;
+            }
+        }
+
+        return snapped;
+    }
+
+    /**
+     * Snap both ends of a query and record the induced error bound
+     * @param point1 First point
+     * @param point2 Second point
+     * @return Snapped pair
+     */
+    std::pair<Point, Point> snapPair(const Point& point1, const Point& point2) {
+        if (mode == SnapMode::None) {
+            return std::make_pair(point1, point2);
+        }
+
+        Point snapped1 = snap(point1);
+        Point snapped2 = snap(point2);
+        double displacement1 = point1.distanceTo(snapped1);
+        double displacement2 = point2.distanceTo(snapped2);
+        double errorBound = displacement1 + displacement2;
+
+        stats.snappedQueries++;
+        stats.totalErrorBoundKm += errorBound;
+        stats.maxErrorBoundKm = std::max(stats.maxErrorBoundKm, errorBound);
+        stats.maxDisplacementKm = std::max({stats.maxDisplacementKm, displacement1, displacement2});
+
+        return std::make_pair(snapped1, snapped2);
+    }
+
+    /**
+     * Get induced error statistics
+     * @return Snap statistics
+     */
+    const SnapStats& getSnapStats() const {
+        return stats;
+    }
+
+    /**
+     * Reset induced error statistics
+     */
+    void resetStats() {
+        stats = SnapStats();
+    }
+};
+
+#endif // COORDINATE_SNAPPER_H
@@ -0,0 +1,276 @@
+#ifndef DISTANCE_BACKEND_H
+#define DISTANCE_BACKEND_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <queue>
+#include <limits>
+#include <stdexcept>
+#include <sstream>
+#include <memory>
+#include "HttpTransport.h"
+#include "AStarAlgorithm.h"
+#include "Graph.h"
+
+/**
+ * A source of point-to-point distances. Implementations throw on failure so
+ * that callers (the query planner) can record the failure and fall back.
+ */
+class DistanceBackend {
+public:
+    virtual ~DistanceBackend() = default;
+
+    /**
+     * Get backend name used in statistics and logs
+     * @return Backend name
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * Calculate distance between two points
+     * @param point1 First point
+     * @param point2 Second point
+     * @return Distance in kilometers
+     */
+    virtual double calculateDistance(const Point& point1, const Point& point2) = 0;
+
+    /**
+     * Whether this backend returns true road distances and can be used as the
+     * accuracy reference for the other backends
+     * @return True for reference backends
+     */
+    virtual bool isReference() const { return false; }
+
+    /**
+     * Whether results are road distances (worth caching) rather than a
+     * straight-line estimate
+     * @return False for estimates
+     */
+    virtual bool isRoadDistance() const { return true; }
+};
+
+/**
+ * Straight-line distance; a lower bound for every other backend
+ */
+class HaversineBackend : public DistanceBackend {
+public:
+    std::string getName() const override { return "haversine"; }
+
+    bool isRoadDistance() const override { return false; }
+
+    double calculateDistance(const Point& point1, const Point& point2) override {
+        return point1.distanceTo(point2);
+    }
+};
+
+/**
+ * Grid-based A* search. Caching is left to the caller (RoadDistanceService
+ * reads through the shared DistanceCache before querying any backend).
+ * Pairs beyond the search distance or without a grid path throw instead of
+ * returning a straight-line distance, so they count as failures.
+ */
+class GridAStarBackend : public DistanceBackend {
+private:
+    AStarAlgorithm aStarAlgorithm;
+
+public:
+    std::string getName() const override { return "grid_astar"; }
+
+    double calculateDistance(const Point& point1, const Point& point2) override {
+        double distance;
+        if (!aStarAlgorithm.searchPath(point1, point2, distance)) {
+            std::ostringstream message;
+            message << "No A* path within " << aStarAlgorithm.getMaxDistance() << " km";
+            throw std::runtime_error(message.str());
+        }
+        return distance;
+    }
+
+    AStarAlgorithm& getAStarAlgorithm() {
+        return aStarAlgorithm;
+    }
+};
+
+/**
+ * Dijkstra over the local road graph. Graph edge weights are in meters and
+ * query points are snapped to their nearest graph vertex.
+ */
+class GraphBackend : public DistanceBackend {
+private:
+    const Graph& graph;
+    std::unordered_map<std::string, Point> vertexLocations;
+
+public:
+    GraphBackend(const Graph& g, const std::unordered_map<std::string, Point>& locations)
+        : graph(g), vertexLocations(locations) {}
+
+    std::string getName() const override { return "local_graph"; }
+
+    double calculateDistance(const Point& point1, const Point& point2) override {
+        std::string source = findNearestVertex(point1);
+        std::string target = findNearestVertex(point2);
+
+        double roadDistance = shortestPath(source, target);
+        if (roadDistance < 0) {
+            throw std::runtime_error("No path in local graph between " + source + " and " + target);
+        }
+
+        // Add the snapping legs at both ends
+        return point1.distanceTo(vertexLocations.at(source)) + roadDistance +
+               point2.distanceTo(vertexLocations.at(target));
+    }
+
+    /**
+     * Find the graph vertex closest to a point
+     * @param point Query point
+     * @return Vertex name
+     */
+    std::string findNearestVertex(const Point& point) const {
+        std::string nearest;
+        double nearestDistance = std::numeric_limits<double>::max();
+
+        for (const auto& [vertex, location] : vertexLocations) {
+            double distance = point.distanceTo(location);
+            if (distance < nearestDistance) {
+                nearestDistance = distance;
+                nearest = vertex;
+            }
+        }
+
+        if (nearest.empty()) {
+            throw std::runtime_error("Local graph has no vertex locations");
+        }
+        return nearest;
+    }
+
+private:
+    /**
+     * Dijkstra shortest path between two vertices
+     * @param source Source vertex
+     * @param target Target vertex
+     * @return Distance in kilometers, or -1 if unreachable
+     */
+    double shortestPath(const std::string& source, const std::string& target) const {
+        if (source == target) return 0.0;
+
+        const auto& adjacencyList = graph.getAdjacencyList();
+        std::unordered_map<std::string, long long> dist;
+        using QueueEntry = std::pair<long long, std::string>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openSet;
+
+        dist[source] = 0;
+        openSet.push({0, source});
+
+        while (!openSet.empty()) {
+            auto [currentDist, vertex] = openSet.top();
+            openSet.pop();
+
+            if (vertex == target) {
+                return currentDist / 1000.0;
+            }
+            if (currentDist > dist[vertex]) continue;
+
+            auto it = adjacencyList.find(vertex);
+            if (it == adjacencyList.end()) continue;
+
+            for (const auto& [neighbor, weight] : it->second) {
+                long long candidate = currentDist + weight;
+                auto known = dist.find(neighbor);
+                if (known == dist.end() || candidate < known->second) {
+                    dist[neighbor] = candidate;
+                    openSet.push({candidate, neighbor});
+                }
+            }
+        }
+
+        return -1;
+    }
+};
+
+/**
+ * OSRM HTTP route service
+ */
+class OSRMBackend : public DistanceBackend {
+private:
+    std::string baseUrl;
+    std::shared_ptr<HttpTransport> transport;
+
+public:
+    OSRMBackend(const std::string& url = "https://router.project-osrm.org/route/v1/driving",
+                std::shared_ptr<HttpTransport> httpTransport = nullptr)
+        : baseUrl(url), transport(httpTransport ? httpTransport : std::make_shared<CurlTransport>()) {}
+
+    std::string getName() const override { return "osrm"; }
+
+    bool isReference() const override { return true; }
+
+    /**
+     * Calculate distance using OSRM API
+     * @param point1 First point
+     * @param point2 Second point
+     * @return Distance in kilometers
+     */
+    double calculateDistance(const Point& point1, const Point& point2) override {
+        // Build OSRM URL
+        std::ostringstream urlStream;
+        urlStream << baseUrl << "/"
+                  << point1.longitude << "," << point1.latitude << ";"
+                  << point2.longitude << "," << point2.latitude
+                  << "?overview=false";
+
+        return parseOSRMResponse(transport->get(urlStream.str()));
+    }
+
+    /**
+     * Replace the HTTP transport (e.g. with a recording or replay transport)
+     * @param httpTransport Transport to use for subsequent requests
+     */
+    void setTransport(std::shared_ptr<HttpTransport> httpTransport) {
+        transport = httpTransport;
+    }
+
+    std::shared_ptr<HttpTransport> getTransport() const {
+        return transport;
+    }
+
+    /**
+     * Create a backend with the same server and its own HTTP transport, for
+     * use on another thread
+     * @return New backend, or null if the transport cannot be duplicated
+     */
+    std::shared_ptr<OSRMBackend> createWorker() const {
+        std::shared_ptr<HttpTransport> workerTransport = transport->createWorker();
+        return workerTransport ? std::make_shared<OSRMBackend>(baseUrl, workerTransport) : nullptr;
+    }
+
+private:
+    /**
+     * Parse OSRM JSON response to extract distance
+     * @param response JSON response string
+     * @return Distance in kilometers
+     */
+    double parseOSRMResponse(const std::string& response) {
+        // Simple JSON parsing for distance extraction
+        // Look for "distance": value in the response
+        size_t distancePos = response.find("\"distance\":");
+        if (distancePos == std::string::npos) {
+            throw std::runtime_error("Distance not found in OSRM response");
+        }
+
+        // Find the distance value
+        size_t valueStart = response.find_first_of("0123456789", distancePos);
+        size_t valueEnd = response.find_first_not_of("0123456789.", valueStart);
+
+        if (valueStart == std::string::npos) {
+            throw std::runtime_error("Invalid distance value in OSRM response");
+        }
+
+        std::string distanceStr = response.substr(valueStart, valueEnd - valueStart);
+        double distanceMeters = std::stod(distanceStr);
+
+        return distanceMeters / 1000.0; // Convert meters to kilometers
+    }
+};
+
+#endif // DISTANCE_BACKEND_H
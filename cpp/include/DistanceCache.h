@@ -0,0 +1,462 @@
+#ifndef DISTANCE_CACHE_H
+#define DISTANCE_CACHE_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <functional>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "RandomPointGenerator.h"
+
+/**
+ * Order-independent key of a point pair, quantized to 1e-6 degrees (the
+ * precision of the former string keys). Each point is packed into one word
+ * with offset coordinates, so a valid key never has first == 0.
+ */
+struct DistancePairKey {
+    uint64_t first;
+    uint64_t second;
+
+    bool operator==(const DistancePairKey& other) const {
+        return first == other.first && second == other.second;
+    }
+
+    static DistancePairKey fromPoints(const Point& point1, const Point& point2) {
+        uint64_t a = pack(point1);
+        uint64_t b = pack(point2);
+        return a < b ? DistancePairKey{a, b} : DistancePairKey{b, a};
+    }
+
+    uint64_t hash() const {
+        // splitmix64 finalizer over both words
+        uint64_t h = first * 0x9E3779B97F4A7C15ULL ^ second;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+private:
+    static uint64_t pack(const Point& point) {
+        uint64_t lat = static_cast<uint64_t>(std::llround(point.latitude * 1e6) + 90000001LL);
+        uint64_t lng = static_cast<uint64_t>(std::llround(point.longitude * 1e6) + 180000001LL);
+        return (lat << 32) | (lng & 0xFFFFFFFFULL);
+    }
+};
+
+struct DistancePairKeyHash {
+    size_t operator()(const DistancePairKey& key) const {
+        return static_cast<size_t>(key.hash());
+    }
+};
+
+/**
+ * Two-tier cache of pair distances shared by every distance source.
+ *
+ * L1 is an in-process map split into independently locked shards, with
+ * entries expiring after the configured timeout. L2 is an optional
+ * memory-mapped open-addressing table in a file, which survives restarts and
+ * does not expire; L2 hits are promoted into L1. Because nothing expires
+ * there, getOrCompute() only stores results the caller marks authoritative
+ * (road distances, never a straight-line fallback).
+ */
+class DistanceCache {
+private:
+    static constexpr size_t SHARD_COUNT = 64;
+    static constexpr size_t STORE_HEADER_SIZE = 64;
+    static constexpr double STORE_MAX_LOAD = 0.7;
+
+    struct L1Entry {
+        double distance;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<DistancePairKey, L1Entry, DistancePairKeyHash> entries;
+    };
+
+    struct StoreHeader {
+        char magic[8];
+        uint64_t capacity;
+        uint64_t count;
+    };
+
+    struct StoreSlot {
+        uint64_t first;   // 0 marks an empty slot
+        uint64_t second;
+        double distance;
+    };
+
+    Shard shards[SHARD_COUNT];
+    int timeoutMs;
+
+    mutable std::mutex storeMutex;
+    std::string storePath;
+    unsigned char* storeBase;
+    size_t storeBytes;
+
+    std::atomic<long long> l1Hits;
+    std::atomic<long long> l2Hits;
+    std::atomic<long long> misses;
+
+public:
+    /**
+     * @param timeout L1 entry lifetime in milliseconds
+     */
+    explicit DistanceCache(int timeout = 300000)
+        : timeoutMs(timeout), storeBase(nullptr), storeBytes(0), l1Hits(0), l2Hits(0), misses(0) {}
+
+    ~DistanceCache() {
+        closePersistentStore();
+    }
+
+    DistanceCache(const DistanceCache&) = delete;
+    DistanceCache& operator=(const DistanceCache&) = delete;
+
+    /**
+     * Look up a pair in L1, then L2
+     * @param point1 First point
+     * @param point2 Second point
+     * @param distance Receives the cached distance on a hit
+     * @return True on a hit
+     */
+    bool lookup(const Point& point1, const Point& point2, double& distance) {
+        DistancePairKey key = DistancePairKey::fromPoints(point1, point2);
+        Shard& shard = shardFor(key);
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                if (!isExpired(it->second)) {
+                    distance = it->second.distance;
+                    l1Hits++;
+                    return true;
+                }
+                shard.entries.erase(it);
+            }
+        }
+
+        if (lookupStore(key, distance)) {
+            l2Hits++;
+            insertL1(key, distance);
+            return true;
+        }
+
+        misses++;
+        return false;
+    }
+
+    /**
+     * Store a distance in both tiers
+     * @param point1 First point
+     * @param point2 Second point
+     * @param distance Distance in kilometers
+     */
+    void store(const Point& point1, const Point& point2, double distance) {
+        DistancePairKey key = DistancePairKey::fromPoints(point1, point2);
+        insertL1(key, distance);
+        insertStore(key, distance);
+    }
+
+    /**
+     * Return the cached distance or compute it, storing only authoritative results
+     * @param point1 First point
+     * @param point2 Second point
+     * @param compute Computes (distance, authoritative) on a miss
+     * @return Distance in kilometers
+     */
+    double getOrCompute(const Point& point1, const Point& point2,
+                        const std::function<std::pair<double, bool>()>& compute) {
+        double distance;
+        if (lookup(point1, point2, distance)) {
+            return distance;
+        }
+        std::pair<double, bool> computed = compute();
+        if (computed.second) {
+            store(point1, point2, computed.first);
+        }
+        return computed.first;
+    }
+
+    /**
+     * Back the cache with a persistent file, created if it does not exist.
+     * The table doubles in size when it exceeds 70% load.
+     * @param path Store file
+     * @param initialCapacity Slots for a new store (rounded up to a power of two)
+     */
+    void openPersistentStore(const std::string& path, size_t initialCapacity = 1 << 20) {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        unmapStore();
+        storePath = path;
+
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd >= 0) {
+            StoreHeader header = {};
+            struct stat fileStat;
+            bool readable = ::fstat(fd, &fileStat) == 0 &&
+                ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+            if (readable && std::memcmp(header.magic, "RADCACH1", sizeof(header.magic)) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Not a distance cache file: " + path);
+            }
+            if (readable && isValidStore(header, static_cast<size_t>(fileStat.st_size))) {
+                mapStore(fd, storeFileSize(header.capacity));
+                return;
+            }
+            // Truncated or corrupt: mapping it would fault or probe with a broken mask
+            ::close(fd);
+            std::cerr << "Distance cache file " << path << " is damaged; recreating it" << std::endl;
+        }
+
+        size_t capacity = 1;
+        while (capacity < initialCapacity) capacity <<= 1;
+        createStore(path, capacity);
+    }
+
+    /**
+     * Unmap the persistent store; L1 keeps working
+     */
+    void closePersistentStore() {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        unmapStore();
+        storePath.clear();
+    }
+
+    bool hasPersistentStore() const {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        return storeBase != nullptr;
+    }
+
+    /**
+     * Set L1 entry lifetime
+     * @param timeout Lifetime in milliseconds
+     */
+    void setTimeout(int timeout) {
+        timeoutMs = timeout;
+    }
+
+    int getTimeout() const {
+        return timeoutMs;
+    }
+
+    /**
+     * Clear L1 and reset hit statistics. The persistent tier is kept; use
+     * clearPersistentStore() to empty it.
+     */
+    void clear() {
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+        }
+        l1Hits = 0;
+        l2Hits = 0;
+        misses = 0;
+    }
+
+    /**
+     * Remove every entry of the persistent tier
+     */
+    void clearPersistentStore() {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        if (!storeBase) return;
+        StoreHeader* header = storeHeader();
+        std::memset(storeSlots(), 0, header->capacity * sizeof(StoreSlot));
+        header->count = 0;
+    }
+
+    /**
+     * Get number of entries in L1
+     * @return Entry count
+     */
+    size_t size() {
+        size_t total = 0;
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+    /**
+     * Get per-tier statistics
+     * @return Statistics
+     */
+    std::map<std::string, int> getCacheStats() {
+        std::map<std::string, int> stats;
+        stats["l1_size"] = static_cast<int>(size());
+        stats["l1_hits"] = static_cast<int>(l1Hits.load());
+        stats["l2_hits"] = static_cast<int>(l2Hits.load());
+        stats["misses"] = static_cast<int>(misses.load());
+
+        std::lock_guard<std::mutex> lock(storeMutex);
+        stats["l2_size"] = storeBase ? static_cast<int>(storeHeader()->count) : 0;
+        stats["l2_capacity"] = storeBase ? static_cast<int>(storeHeader()->capacity) : 0;
+        return stats;
+    }
+
+private:
+    Shard& shardFor(const DistancePairKey& key) {
+        return shards[key.hash() % SHARD_COUNT];
+    }
+
+    bool isExpired(const L1Entry& entry) const {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - entry.timestamp);
+        return elapsed.count() > timeoutMs;
+    }
+
+    void insertL1(const DistancePairKey& key, double distance) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries[key] = L1Entry{distance, std::chrono::steady_clock::now()};
+    }
+
+    StoreHeader* storeHeader() const {
+        return reinterpret_cast<StoreHeader*>(storeBase);
+    }
+
+    StoreSlot* storeSlots() const {
+        return reinterpret_cast<StoreSlot*>(storeBase + STORE_HEADER_SIZE);
+    }
+
+    static size_t storeFileSize(size_t capacity) {
+        return STORE_HEADER_SIZE + capacity * sizeof(StoreSlot);
+    }
+
+    /**
+     * Check a store header against the file it came from
+     * @return True if the capacity is a nonzero power of two that fits the
+     *         file and the count leaves an empty slot for probing
+     */
+    static bool isValidStore(const StoreHeader& header, size_t fileSize) {
+        size_t maxCapacity = (fileSize > STORE_HEADER_SIZE ? fileSize - STORE_HEADER_SIZE : 0) / sizeof(StoreSlot);
+        return header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0 &&
+            header.capacity <= maxCapacity && header.count < header.capacity;
+    }
+
+    /**
+     * Find the slot holding a key or the empty slot where it belongs
+     */
+    static StoreSlot* probe(StoreSlot* slots, size_t capacity, const DistancePairKey& key) {
+        size_t mask = capacity - 1;
+        for (size_t index = key.hash() & mask;; index = (index + 1) & mask) {
+            StoreSlot* slot = &slots[index];
+            if (slot->first == 0 || (slot->first == key.first && slot->second == key.second)) {
+                return slot;
+            }
+        }
+    }
+
+    bool lookupStore(const DistancePairKey& key, double& distance) {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        if (!storeBase) return false;
+
+        StoreSlot* slot = probe(storeSlots(), storeHeader()->capacity, key);
+        if (slot->first == 0) return false;
+        distance = slot->distance;
+        return true;
+    }
+
+    void insertStore(const DistancePairKey& key, double distance) {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        if (!storeBase) return;
+
+        StoreHeader* header = storeHeader();
+        if (header->count + 1 > header->capacity * STORE_MAX_LOAD) {
+            growStore();
+            header = storeHeader();
+        }
+
+        StoreSlot* slot = probe(storeSlots(), header->capacity, key);
+        if (slot->first == 0) {
+            slot->first = key.first;
+            slot->second = key.second;
+            header->count++;
+        }
+        slot->distance = distance;
+    }
+
+    void createStore(const std::string& path, size_t capacity) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot create distance cache file: " + path);
+        }
+        size_t fileSize = storeFileSize(capacity);
+        if (::ftruncate(fd, fileSize) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot size distance cache file: " + path);
+        }
+        mapStore(fd, fileSize);
+
+        StoreHeader* header = storeHeader();
+        std::memcpy(header->magic, "RADCACH1", sizeof(header->magic));
+        header->capacity = capacity;
+        header->count = 0;
+    }
+
+    /**
+     * Rehash into a store of twice the capacity, written next to the current
+     * file and renamed over it
+     */
+    void growStore() {
+        size_t oldCapacity = storeHeader()->capacity;
+        std::vector<StoreSlot> occupied;
+        occupied.reserve(storeHeader()->count);
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (storeSlots()[i].first != 0) {
+                occupied.push_back(storeSlots()[i]);
+            }
+        }
+
+        std::string path = storePath;
+        std::string tempPath = path + ".tmp";
+        unmapStore();
+        createStore(tempPath, oldCapacity * 2);
+
+        StoreHeader* header = storeHeader();
+        for (const StoreSlot& entry : occupied) {
+            *probe(storeSlots(), header->capacity, DistancePairKey{entry.first, entry.second}) = entry;
+        }
+        header->count = occupied.size();
+
+        msync(storeBase, storeBytes, MS_SYNC);
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Cannot replace distance cache file: " + path);
+        }
+        storePath = path;
+    }
+
+    void mapStore(int fd, size_t fileSize) {
+        void* memory = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            throw std::runtime_error("Cannot map distance cache file: " + storePath);
+        }
+        storeBase = static_cast<unsigned char*>(memory);
+        storeBytes = fileSize;
+    }
+
+    void unmapStore() {
+        if (storeBase) {
+            munmap(storeBase, storeBytes);
+            storeBase = nullptr;
+            storeBytes = 0;
+        }
+    }
+};
+
+#endif // DISTANCE_CACHE_H
@@ -0,0 +1,552 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <functional>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+enum class MatrixPrecision {
+    Float32,  // 4 bytes per entry
+    Fixed16   // 2 bytes per entry, fixed-point with a configurable resolution
+};
+
+enum class MatrixLayout {
+    PersonMajor,  // One storage row per person (row scans find a person's best center)
+    CenterMajor   // One storage row per center (row scans visit all people of a center)
+};
+
+/**
+ * People x centers distance matrix in a single contiguous, 64-byte aligned buffer.
+ *
+ * Every storage row starts on a 64-byte boundary and is padded to a whole
+ * number of 64-byte blocks; padding holds the "unreachable" value (+inf for
+ * Float32, UINT16_MAX for Fixed16) so vector kernels can process full rows
+ * without a scalar tail. In Fixed16 UINT16_MAX is reserved for +inf; a finite
+ * distance beyond the representable range is rejected by set() rather than
+ * stored as unreachable, so callers size the resolution with
+ * fixedResolutionFor(), or fill through setWidening() when the maximum is
+ * only known once every distance has been computed.
+ *
+ * The buffer is either heap memory (transparent huge pages are requested for
+ * large matrices) or a memory-mapped file for matrices that do not fit in RAM.
+ * File-backed matrices are written in row tiles and streamed back with the
+ * access hints below, so the kernel keeps only the working tiles resident.
+ */
+class DistanceMatrix {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr uint16_t FIXED_UNREACHABLE = std::numeric_limits<uint16_t>::max();
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t MAPPED_HEADER_SIZE = 4096; // Keeps row data page aligned
+
+private:
+    struct MappedHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t precision;
+        uint32_t layout;
+        uint32_t reserved;
+        uint64_t personCount;
+        uint64_t centerCount;
+        uint64_t rowStride;
+        double fixedResolutionKm;
+    };
+
+    using Buffer = std::unique_ptr<unsigned char, std::function<void(unsigned char*)>>;
+
+    size_t personCount;
+    size_t centerCount;
+    size_t rowStride; // Entries per storage row including padding
+    MatrixPrecision precision;
+    MatrixLayout layout;
+    double fixedResolutionKm; // Kilometers per Fixed16 unit
+    Buffer buffer;
+    unsigned char* mappingBase; // Start of the file mapping (header), nullptr for heap storage
+
+public:
+    DistanceMatrix()
+        : personCount(0), centerCount(0), rowStride(0)
+        , precision(MatrixPrecision::Float32), layout(MatrixLayout::PersonMajor)
+        , fixedResolutionKm(0.01), mappingBase(nullptr) {}
+
+    /**
+     * Allocate a matrix filled with the unreachable value
+     * @param people Number of people (rows)
+     * @param centers Number of test centers (columns)
+     * @param prec Storage precision
+     * @param lay Storage layout
+     * @param resolutionKm Kilometers per unit for Fixed16 (0.01 km covers up to 655 km)
+     */
+    DistanceMatrix(size_t people, size_t centers,
+                   MatrixPrecision prec = MatrixPrecision::Float32,
+                   MatrixLayout lay = MatrixLayout::PersonMajor,
+                   double resolutionKm = 0.01)
+        : personCount(people), centerCount(centers), rowStride(0)
+        , precision(prec), layout(lay), fixedResolutionKm(resolutionKm), mappingBase(nullptr) {
+
+        computeRowStride();
+
+        size_t bytes = getMemoryBytes();
+        if (bytes > 0) {
+            // Huge-page alignment lets the kernel back large matrices with 2 MB pages
+            size_t alignment = bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : ALIGNMENT;
+            size_t allocation = (bytes + alignment - 1) / alignment * alignment;
+            void* memory = std::aligned_alloc(alignment, allocation);
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            if (alignment == HUGE_PAGE_SIZE) {
+                madvise(memory, allocation, MADV_HUGEPAGE);
+            }
+#endif
+            buffer = Buffer(static_cast<unsigned char*>(memory), [](unsigned char* p) { std::free(p); });
+        }
+
+        fillUnreachable();
+    }
+
+    /**
+     * Create a matrix stored in a memory-mapped file. Entries are zero until
+     * written; writers call padRows() for each finished tile so padding holds
+     * the unreachable value.
+     * @param path File to create or truncate
+     * @param people Number of people
+     * @param centers Number of test centers
+     * @param prec Storage precision
+     * @param lay Storage layout
+     * @param resolutionKm Kilometers per unit for Fixed16
+     * @return File-backed matrix
+     */
+    static DistanceMatrix createMapped(const std::string& path, size_t people, size_t centers,
+                                       MatrixPrecision prec = MatrixPrecision::Float32,
+                                       MatrixLayout lay = MatrixLayout::PersonMajor,
+                                       double resolutionKm = 0.01) {
+        DistanceMatrix matrix;
+        matrix.personCount = people;
+        matrix.centerCount = centers;
+        matrix.precision = prec;
+        matrix.layout = lay;
+        matrix.fixedResolutionKm = resolutionKm;
+        matrix.computeRowStride();
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot create distance matrix file: " + path);
+        }
+
+        size_t fileSize = MAPPED_HEADER_SIZE + matrix.getMemoryBytes();
+        if (::ftruncate(fd, fileSize) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot size distance matrix file: " + path);
+        }
+
+        matrix.mapFile(fd, fileSize, path);
+
+        MappedHeader header = {};
+        std::memcpy(header.magic, "RAMATRX1", sizeof(header.magic));
+        header.version = 1;
+        header.precision = static_cast<uint32_t>(prec);
+        header.layout = static_cast<uint32_t>(lay);
+        header.personCount = people;
+        header.centerCount = centers;
+        header.rowStride = matrix.rowStride;
+        header.fixedResolutionKm = resolutionKm;
+        std::memcpy(matrix.mappingBase, &header, sizeof(header));
+
+        return matrix;
+    }
+
+    /**
+     * Open a matrix file written by createMapped()
+     * @param path Matrix file
+     * @return File-backed matrix
+     */
+    static DistanceMatrix openMapped(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open distance matrix file: " + path);
+        }
+
+        MappedHeader header = {};
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0 ||
+            ::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, "RAMATRX1", sizeof(header.magic)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Not a distance matrix file: " + path);
+        }
+        if (header.version != 1 ||
+            header.precision > static_cast<uint32_t>(MatrixPrecision::Fixed16) ||
+            header.layout > static_cast<uint32_t>(MatrixLayout::CenterMajor) ||
+            (header.precision == static_cast<uint32_t>(MatrixPrecision::Fixed16) &&
+             !(std::isfinite(header.fixedResolutionKm) && header.fixedResolutionKm > 0))) {
+            ::close(fd);
+            throw std::runtime_error("Unsupported distance matrix file version or format: " + path);
+        }
+        // Each entry takes at least two bytes, so larger dimensions cannot fit the file
+        if (header.personCount > static_cast<uint64_t>(fileStat.st_size) ||
+            header.centerCount > static_cast<uint64_t>(fileStat.st_size)) {
+            ::close(fd);
+            throw std::runtime_error("Truncated distance matrix file: " + path);
+        }
+
+        DistanceMatrix matrix;
+        matrix.personCount = header.personCount;
+        matrix.centerCount = header.centerCount;
+        matrix.precision = static_cast<MatrixPrecision>(header.precision);
+        matrix.layout = static_cast<MatrixLayout>(header.layout);
+        matrix.fixedResolutionKm = header.fixedResolutionKm;
+        matrix.computeRowStride();
+
+        size_t fileSize = MAPPED_HEADER_SIZE + matrix.getMemoryBytes();
+        if (matrix.rowStride != header.rowStride || static_cast<size_t>(fileSize) > static_cast<size_t>(fileStat.st_size)) {
+            ::close(fd);
+            throw std::runtime_error("Truncated distance matrix file: " + path);
+        }
+
+        matrix.mapFile(fd, fileSize, path);
+        return matrix;
+    }
+
+    DistanceMatrix(DistanceMatrix&& other) noexcept
+        : personCount(other.personCount), centerCount(other.centerCount), rowStride(other.rowStride)
+        , precision(other.precision), layout(other.layout), fixedResolutionKm(other.fixedResolutionKm)
+        , buffer(std::move(other.buffer)), mappingBase(other.mappingBase) {
+        other.personCount = other.centerCount = other.rowStride = 0;
+        other.mappingBase = nullptr;
+    }
+
+    DistanceMatrix& operator=(DistanceMatrix&& other) noexcept {
+        if (this != &other) {
+            personCount = other.personCount;
+            centerCount = other.centerCount;
+            rowStride = other.rowStride;
+            precision = other.precision;
+            layout = other.layout;
+            fixedResolutionKm = other.fixedResolutionKm;
+            buffer = std::move(other.buffer);
+            mappingBase = other.mappingBase;
+            other.personCount = other.centerCount = other.rowStride = 0;
+            other.mappingBase = nullptr;
+        }
+        return *this;
+    }
+    DistanceMatrix(const DistanceMatrix&) = delete;
+    DistanceMatrix& operator=(const DistanceMatrix&) = delete;
+
+    /**
+     * Get distance for a pair
+     * @param personIndex Person index
+     * @param centerIndex Center index
+     * @return Distance in kilometers (+inf if unreachable)
+     */
+    double get(size_t personIndex, size_t centerIndex) const {
+        size_t offset = entryOffset(personIndex, centerIndex);
+        if (precision == MatrixPrecision::Float32) {
+            return reinterpret_cast<const float*>(buffer.get())[offset];
+        }
+        uint16_t value = reinterpret_cast<const uint16_t*>(buffer.get())[offset];
+        return value == FIXED_UNREACHABLE ? std::numeric_limits<double>::infinity() : value * fixedResolutionKm;
+    }
+
+    /**
+     * Set distance for a pair
+     * @param personIndex Person index
+     * @param centerIndex Center index
+     * @param distance Distance in kilometers (+inf = unreachable)
+     * @throws std::runtime_error if a finite distance exceeds the Fixed16 range
+     */
+    void set(size_t personIndex, size_t centerIndex, double distance) {
+        size_t offset = entryOffset(personIndex, centerIndex);
+        if (precision == MatrixPrecision::Float32) {
+            reinterpret_cast<float*>(buffer.get())[offset] = static_cast<float>(distance);
+        } else {
+            uint16_t value = toFixed(distance);
+            if (value == FIXED_UNREACHABLE && std::isfinite(distance)) {
+                throw std::runtime_error("Distance " + std::to_string(distance) + " km exceeds the Fixed16 range of " +
+                                         std::to_string(getFixedRange()) + " km; use a coarser resolution");
+            }
+            reinterpret_cast<uint16_t*>(buffer.get())[offset] = value;
+        }
+    }
+
+    /**
+     * Set distance for a pair whose maximum is not known in advance (e.g. road
+     * distances): a finite Fixed16 distance beyond the range widens it first
+     * @param personIndex Person index
+     * @param centerIndex Center index
+     * @param distance Distance in kilometers (+inf = unreachable)
+     */
+    void setWidening(size_t personIndex, size_t centerIndex, double distance) {
+        if (precision == MatrixPrecision::Fixed16 && std::isfinite(distance) && distance > getFixedRange()) {
+            widenFixedRange(std::max(distance, 2.0 * getFixedRange()));
+        }
+        set(personIndex, centerIndex, distance);
+    }
+
+    /**
+     * Coarsen the Fixed16 resolution to cover a larger maximum, re-quantizing
+     * every stored entry (adds up to half a new unit of rounding to each).
+     * Touches the whole buffer, so callers at least double the range per call.
+     * @param maxDistanceKm Largest finite distance to cover
+     */
+    void widenFixedRange(double maxDistanceKm) {
+        double resolution = fixedResolutionFor(maxDistanceKm);
+        if (precision != MatrixPrecision::Fixed16 || resolution <= fixedResolutionKm) return;
+
+        double scale = fixedResolutionKm / resolution;
+        uint16_t* data = reinterpret_cast<uint16_t*>(buffer.get());
+        size_t entries = getStorageRowCount() * rowStride;
+        for (size_t i = 0; i < entries; i++) {
+            if (data[i] != FIXED_UNREACHABLE) {
+                data[i] = static_cast<uint16_t>(std::lround(data[i] * scale));
+            }
+        }
+        fixedResolutionKm = resolution;
+        if (mappingBase) {
+            reinterpret_cast<MappedHeader*>(mappingBase)->fixedResolutionKm = resolution;
+        }
+    }
+
+    /**
+     * Get an aligned Float32 storage row (a person for PersonMajor, a center for CenterMajor)
+     * @param row Storage row index
+     * @return Pointer to getRowStride() floats
+     */
+    const float* floatRow(size_t row) const {
+        if (precision != MatrixPrecision::Float32) {
+            throw std::logic_error("Distance matrix is not Float32");
+        }
+        return reinterpret_cast<const float*>(buffer.get()) + row * rowStride;
+    }
+
+    float* floatRow(size_t row) {
+        return const_cast<float*>(static_cast<const DistanceMatrix*>(this)->floatRow(row));
+    }
+
+    /**
+     * Get an aligned Fixed16 storage row
+     * @param row Storage row index
+     * @return Pointer to getRowStride() fixed-point values
+     */
+    const uint16_t* fixedRow(size_t row) const {
+        if (precision != MatrixPrecision::Fixed16) {
+            throw std::logic_error("Distance matrix is not Fixed16");
+        }
+        return reinterpret_cast<const uint16_t*>(buffer.get()) + row * rowStride;
+    }
+
+    uint16_t* fixedRow(size_t row) {
+        return const_cast<uint16_t*>(static_cast<const DistanceMatrix*>(this)->fixedRow(row));
+    }
+
+    /**
+     * Hint that storage rows will be read or written front to back
+     */
+    void adviseSequential() const {
+        if (mappingBase && getMemoryBytes() > 0) {
+            madvise(mappingBase, MAPPED_HEADER_SIZE + getMemoryBytes(), MADV_SEQUENTIAL);
+        }
+    }
+
+    /**
+     * Ask the kernel to start reading a tile of storage rows ahead of use
+     * @param begin First storage row
+     * @param end One past the last storage row
+     */
+    void prefetchRows(size_t begin, size_t end) const {
+        adviseRows(begin, end, MADV_WILLNEED);
+    }
+
+    /**
+     * Drop a consumed tile of storage rows from the working set; file-backed
+     * data stays in the file and is reloaded on next access
+     * @param begin First storage row
+     * @param end One past the last storage row
+     */
+    void releaseRows(size_t begin, size_t end) const {
+        adviseRows(begin, end, MADV_DONTNEED);
+    }
+
+    /**
+     * Schedule write-back of a finished tile of storage rows
+     * @param begin First storage row
+     * @param end One past the last storage row
+     */
+    void flushRows(size_t begin, size_t end) {
+        size_t offset, length;
+        if (rowRangeToPages(begin, end, offset, length)) {
+            msync(mappingBase + offset, length, MS_ASYNC);
+        }
+    }
+
+    /**
+     * Write the unreachable value into the padding of a tile of storage rows
+     * @param begin First storage row
+     * @param end One past the last storage row
+     */
+    void padRows(size_t begin, size_t end) {
+        size_t used = getStorageRowLength();
+        for (size_t row = begin; row < end && row < getStorageRowCount(); row++) {
+            if (precision == MatrixPrecision::Float32) {
+                float* data = floatRow(row);
+                std::fill(data + used, data + rowStride, std::numeric_limits<float>::infinity());
+            } else {
+                uint16_t* data = fixedRow(row);
+                std::fill(data + used, data + rowStride, FIXED_UNREACHABLE);
+            }
+        }
+    }
+
+    /**
+     * Check whether the matrix is backed by a memory-mapped file
+     * @return True for file-backed matrices
+     */
+    bool isMapped() const {
+        return mappingBase != nullptr;
+    }
+
+    /**
+     * Convert kilometers to the Fixed16 representation
+     * @param distance Distance in kilometers
+     * @return Fixed-point value, saturated to FIXED_UNREACHABLE
+     */
+    uint16_t toFixed(double distance) const {
+        if (!(distance >= 0)) return distance < 0 ? 0 : FIXED_UNREACHABLE;
+        double units = std::round(distance / fixedResolutionKm);
+        return units >= FIXED_UNREACHABLE ? FIXED_UNREACHABLE : static_cast<uint16_t>(units);
+    }
+
+    /**
+     * Get the largest finite distance Fixed16 entries can hold
+     * @return Kilometers
+     */
+    double getFixedRange() const {
+        return (FIXED_UNREACHABLE - 1) * fixedResolutionKm;
+    }
+
+    /**
+     * Choose a Fixed16 resolution covering a maximum distance
+     * @param maxDistanceKm Largest finite distance that will be stored
+     * @return Kilometers per unit, never finer than 0.01 km
+     */
+    static double fixedResolutionFor(double maxDistanceKm) {
+        double needed = std::isfinite(maxDistanceKm) ? maxDistanceKm / (FIXED_UNREACHABLE - 1) : 0.0;
+        return std::max(0.01, needed * 1.001); // Headroom for rounding up to the next unit
+    }
+
+    size_t getPersonCount() const { return personCount; }
+    size_t getCenterCount() const { return centerCount; }
+    size_t getRowStride() const { return rowStride; }
+    MatrixPrecision getPrecision() const { return precision; }
+    MatrixLayout getLayout() const { return layout; }
+    double getFixedResolution() const { return fixedResolutionKm; }
+    bool empty() const { return personCount == 0 || centerCount == 0; }
+
+    /**
+     * Get number of storage rows (people for PersonMajor, centers for CenterMajor)
+     * @return Storage row count
+     */
+    size_t getStorageRowCount() const {
+        return layout == MatrixLayout::PersonMajor ? personCount : centerCount;
+    }
+
+    /**
+     * Get number of used entries per storage row
+     * @return Storage row length
+     */
+    size_t getStorageRowLength() const {
+        return layout == MatrixLayout::PersonMajor ? centerCount : personCount;
+    }
+
+    /**
+     * Get size of the underlying buffer
+     * @return Bytes allocated
+     */
+    size_t getMemoryBytes() const {
+        return getStorageRowCount() * rowStride * entrySize();
+    }
+
+private:
+    void computeRowStride() {
+        size_t entriesPerBlock = ALIGNMENT / entrySize();
+        rowStride = (getStorageRowLength() + entriesPerBlock - 1) / entriesPerBlock * entriesPerBlock;
+    }
+
+    void mapFile(int fd, size_t fileSize, const std::string& path) {
+        void* memory = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            throw std::runtime_error("Cannot map distance matrix file: " + path);
+        }
+#ifdef MADV_HUGEPAGE
+        // Only honoured by filesystems supporting huge pages; ignored elsewhere
+        madvise(memory, fileSize, MADV_HUGEPAGE);
+#endif
+        mappingBase = static_cast<unsigned char*>(memory);
+        buffer = Buffer(mappingBase + MAPPED_HEADER_SIZE, [memory, fileSize](unsigned char*) {
+            munmap(memory, fileSize);
+        });
+    }
+
+    /**
+     * Convert a storage row range to a page-aligned byte range of the mapping
+     * @return False for heap storage or an empty range
+     */
+    bool rowRangeToPages(size_t begin, size_t end, size_t& offset, size_t& length) const {
+        end = std::min(end, getStorageRowCount());
+        if (!mappingBase || begin >= end) return false;
+
+        size_t rowBytes = rowStride * entrySize();
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t first = MAPPED_HEADER_SIZE + begin * rowBytes;
+        size_t last = MAPPED_HEADER_SIZE + end * rowBytes;
+
+        offset = first / pageSize * pageSize;
+        length = last - offset;
+        return true;
+    }
+
+    void adviseRows(size_t begin, size_t end, int advice) const {
+        size_t offset, length;
+        if (rowRangeToPages(begin, end, offset, length)) {
+            madvise(mappingBase + offset, length, advice);
+        }
+    }
+
+    size_t entrySize() const {
+        return precision == MatrixPrecision::Float32 ? sizeof(float) : sizeof(uint16_t);
+    }
+
+    size_t entryOffset(size_t personIndex, size_t centerIndex) const {
+        return layout == MatrixLayout::PersonMajor ?
+            personIndex * rowStride + centerIndex :
+            centerIndex * rowStride + personIndex;
+    }
+
+    void fillUnreachable() {
+        size_t entries = getStorageRowCount() * rowStride;
+        if (precision == MatrixPrecision::Float32) {
+            float* data = reinterpret_cast<float*>(buffer.get());
+            std::fill(data, data + entries, std::numeric_limits<float>::infinity());
+        } else {
+            uint16_t* data = reinterpret_cast<uint16_t*>(buffer.get());
+            std::fill(data, data + entries, FIXED_UNREACHABLE);
+        }
+    }
+};
+
+#endif // DISTANCE_MATRIX_H
@@ -0,0 +1,365 @@
+#ifndef DISTANCE_QUERY_PLANNER_H
+#define DISTANCE_QUERY_PLANNER_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <limits>
+#include <iostream>
+#include "DistanceBackend.h"
+
+/**
+ * Measured behaviour of one backend within one straight-line distance band
+ */
+struct BackendBandStats {
+    int queries;
+    int failures;
+    double totalLatencyMs;
+    int calibrations;
+    double totalRelativeError;
+
+    BackendBandStats() : queries(0), failures(0), totalLatencyMs(0), calibrations(0), totalRelativeError(0) {}
+
+    double averageLatencyMs() const {
+        return queries > 0 ? totalLatencyMs / queries : 0.0;
+    }
+
+    double averageRelativeError() const {
+        return calibrations > 0 ? totalRelativeError / calibrations : 0.0;
+    }
+
+    double failureRate() const {
+        return queries > 0 ? static_cast<double>(failures) / queries : 0.0;
+    }
+};
+
+/**
+ * Picks a distance backend per pair (or per batch) from measured latency and
+ * accuracy, bucketed by straight-line distance.
+ *
+ * Each backend is registered with a prior (expected latency and relative
+ * error up to a maximum distance) that is used until a band has enough
+ * samples. Every calibrationInterval-th query in a band is also sent to the
+ * reference backend so relative errors can be measured, and every
+ * explorationInterval-th query is also sent, as a shadow query, to the
+ * least-sampled backend so that unexplored bands are eventually learned.
+ * Shadow results are only recorded; the caller always gets the answer of
+ * the selected backend.
+ *
+ * Only a result of the selected backend that is a road distance is
+ * authoritative; straight-line results and the Haversine fallback after a
+ * failure are not, and must not be cached.
+ */
+class DistanceQueryPlanner {
+private:
+    struct BackendEntry {
+        std::shared_ptr<DistanceBackend> backend;
+        double priorLatencyMs;
+        double priorRelativeError;
+        double priorMaxDistanceKm;
+        std::vector<BackendBandStats> bandStats;
+    };
+
+    std::vector<BackendEntry> backends;
+    std::vector<double> bandLimitsKm;
+    std::vector<int> bandQueries;
+    double accuracyWeightMs;  // Cost in ms of a 100% relative error
+    double failurePenaltyMs;  // Cost in ms of a failed query
+    int minSamples;
+    int calibrationInterval;
+    int explorationInterval;
+
+public:
+    DistanceQueryPlanner()
+        : bandLimitsKm({1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0})
+        , bandQueries(bandLimitsKm.size() + 1, 0)
+        , accuracyWeightMs(1000.0)
+        , failurePenaltyMs(10000.0)
+        , minSamples(20)
+        , calibrationInterval(50)
+        , explorationInterval(100) {}
+
+    /**
+     * Register a backend with its prior cost model
+     * @param backend Backend to register
+     * @param priorLatencyMs Expected latency per query before measurements exist
+     * @param priorRelativeError Expected relative error against the reference backend
+     * @param priorMaxDistanceKm Distance beyond which the prior does not apply
+     * @return Backend index
+     */
+    int addBackend(std::shared_ptr<DistanceBackend> backend, double priorLatencyMs,
+                   double priorRelativeError,
+                   double priorMaxDistanceKm = std::numeric_limits<double>::max()) {
+        BackendEntry entry;
+        entry.backend = backend;
+        entry.priorLatencyMs = priorLatencyMs;
+        entry.priorRelativeError = backend->isReference() ? 0.0 : priorRelativeError;
+        entry.priorMaxDistanceKm = priorMaxDistanceKm;
+        entry.bandStats.resize(bandLimitsKm.size() + 1);
+        backends.push_back(entry);
+        return backends.size() - 1;
+    }
+
+    /**
+     * Swap a registered backend for another instance, keeping its prior and
+     * the measurements made so far
+     * @param registered Backend currently registered
+     * @param replacement Backend taking its place
+     * @return False if the backend is not registered
+     */
+    bool replaceBackend(const std::shared_ptr<DistanceBackend>& registered,
+                        std::shared_ptr<DistanceBackend> replacement) {
+        for (BackendEntry& entry : backends) {
+            if (entry.backend == registered) {
+                entry.backend = replacement;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Calculate distance with the backend the planner currently considers cheapest
+     * @param point1 First point
+     * @param point2 Second point
+     * @return Distance in kilometers
+     */
+    double calculateDistance(const Point& point1, const Point& point2) {
+        return planDistance(point1, point2).first;
+    }
+
+    /**
+     * Calculate distance and report whether it may be cached
+     * @param point1 First point
+     * @param point2 Second point
+     * @return Pair of (distance in km, authoritative)
+     */
+    std::pair<double, bool> planDistance(const Point& point1, const Point& point2) {
+        double straightDistance = point1.distanceTo(point2);
+        int band = getBand(straightDistance);
+        int queryNumber = ++bandQueries[band];
+
+        int backendIndex = selectBackend(straightDistance);
+        if (backendIndex < 0) {
+            return std::make_pair(straightDistance, false);
+        }
+
+        double distance;
+        bool success = runBackend(backendIndex, band, point1, point2, distance);
+        if (success && calibrationInterval > 0 && queryNumber % calibrationInterval == 0) {
+            calibrate(backendIndex, band, point1, point2, distance);
+        }
+        if (explorationInterval > 0 && queryNumber % explorationInterval == 0) {
+            explore(backendIndex, band, point1, point2);
+        }
+
+        if (!success) {
+            // Fallback to Haversine distance
+            return std::make_pair(straightDistance, false);
+        }
+        return std::make_pair(distance, backends[backendIndex].backend->isRoadDistance());
+    }
+
+    /**
+     * Choose the backend with the lowest expected cost for a pair
+     * @param straightDistance Haversine distance between the pair in km
+     * @return Backend index, or -1 if none is registered
+     */
+    int selectBackend(double straightDistance) const {
+        int band = getBand(straightDistance);
+        int best = -1;
+        double bestScore = std::numeric_limits<double>::max();
+
+        for (size_t i = 0; i < backends.size(); i++) {
+            double score = expectedCost(i, band, straightDistance);
+            if (score < bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+
+        return best;
+    }
+
+    /**
+     * Choose one backend for a whole batch of pairs
+     * @param pairs Point pairs in the batch
+     * @return Backend index minimizing the summed expected cost
+     */
+    int selectBackendForBatch(const std::vector<std::pair<Point, Point>>& pairs) const {
+        std::vector<double> totals(backends.size(), 0.0);
+
+        for (const auto& [point1, point2] : pairs) {
+            double straightDistance = point1.distanceTo(point2);
+            int band = getBand(straightDistance);
+            for (size_t i = 0; i < backends.size(); i++) {
+                totals[i] += expectedCost(i, band, straightDistance);
+            }
+        }
+
+        int best = -1;
+        for (size_t i = 0; i < totals.size(); i++) {
+            if (best == -1 || totals[i] < totals[best]) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Set how many milliseconds a 100% relative error is worth
+     * @param weightMs Accuracy weight
+     */
+    void setAccuracyWeight(double weightMs) {
+        accuracyWeightMs = weightMs;
+    }
+
+    /**
+     * Set sampling intervals for calibration and exploration (0 disables)
+     * @param calibration Calibrate every Nth query per band
+     * @param exploration Explore every Nth query per band
+     */
+    void setSamplingIntervals(int calibration, int exploration) {
+        calibrationInterval = calibration;
+        explorationInterval = exploration;
+    }
+
+    /**
+     * Get the backend registered at an index
+     * @param index Backend index
+     * @return Backend
+     */
+    std::shared_ptr<DistanceBackend> getBackend(int index) const {
+        return backends.at(index).backend;
+    }
+
+    /**
+     * Get per-backend, per-band statistics
+     * @return Statistics keyed by "backend/band_upper_km"
+     */
+    std::map<std::string, BackendBandStats> getBackendStats() const {
+        std::map<std::string, BackendBandStats> stats;
+        for (const auto& entry : backends) {
+            for (size_t band = 0; band < entry.bandStats.size(); band++) {
+                if (entry.bandStats[band].queries == 0) continue;
+                std::string upper = band < bandLimitsKm.size() ?
+                    std::to_string(static_cast<int>(bandLimitsKm[band])) : "inf";
+                stats[entry.backend->getName() + "/" + upper] = entry.bandStats[band];
+            }
+        }
+        return stats;
+    }
+
+    /**
+     * Print learned statistics
+     */
+    void printStats() const {
+        for (const auto& [key, stats] : getBackendStats()) {
+            std::cout << key << ": " << stats.queries << " queries, "
+                      << stats.averageLatencyMs() << " ms avg, "
+                      << stats.averageRelativeError() * 100 << "% error, "
+                      << stats.failures << " failures" << std::endl;
+        }
+    }
+
+private:
+    int getBand(double straightDistance) const {
+        int band = 0;
+        while (band < static_cast<int>(bandLimitsKm.size()) && straightDistance >= bandLimitsKm[band]) {
+            band++;
+        }
+        return band;
+    }
+
+    /**
+     * Expected cost of a query in ms, from measurements when available and
+     * from the registered prior otherwise
+     */
+    double expectedCost(int index, int band, double straightDistance) const {
+        const BackendEntry& entry = backends[index];
+        const BackendBandStats& stats = entry.bandStats[band];
+
+        double latency, error;
+        if (stats.queries >= minSamples) {
+            latency = stats.averageLatencyMs();
+            error = (entry.backend->isReference() || stats.calibrations == 0) ?
+                entry.priorRelativeError : stats.averageRelativeError();
+            latency += stats.failureRate() * failurePenaltyMs;
+        } else if (straightDistance <= entry.priorMaxDistanceKm) {
+            latency = entry.priorLatencyMs;
+            error = entry.priorRelativeError;
+        } else {
+            return std::numeric_limits<double>::max();
+        }
+
+        return latency + accuracyWeightMs * error;
+    }
+
+    int leastSampledBackend(int band) const {
+        int best = -1;
+        for (size_t i = 0; i < backends.size(); i++) {
+            if (best == -1 || backends[i].bandStats[band].queries < backends[best].bandStats[band].queries) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    bool runBackend(int index, int band, const Point& point1, const Point& point2, double& distance) {
+        BackendEntry& entry = backends[index];
+        BackendBandStats& stats = entry.bandStats[band];
+
+        auto startTime = std::chrono::steady_clock::now();
+        bool success = true;
+        try {
+            distance = entry.backend->calculateDistance(point1, point2);
+        } catch (const std::exception& e) {
+            std::cerr << entry.backend->getName() << " distance calculation failed: " << e.what() << std::endl;
+            success = false;
+        }
+        auto endTime = std::chrono::steady_clock::now();
+
+        stats.queries++;
+        stats.totalLatencyMs += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        if (!success) stats.failures++;
+
+        return success;
+    }
+
+    /**
+     * Shadow query to the least-sampled backend of a band: its latency,
+     * failures and calibrated error are recorded, its distance is dropped
+     */
+    void explore(int selected, int band, const Point& point1, const Point& point2) {
+        int explored = leastSampledBackend(band);
+        if (explored < 0 || explored == selected) return;
+
+        double distance;
+        if (runBackend(explored, band, point1, point2, distance)) {
+            calibrate(explored, band, point1, point2, distance);
+        }
+    }
+
+    /**
+     * Compare a result against the reference backend and record the error
+     */
+    void calibrate(int index, int band, const Point& point1, const Point& point2, double distance) {
+        if (backends[index].backend->isReference()) return;
+
+        for (size_t i = 0; i < backends.size(); i++) {
+            if (!backends[i].backend->isReference()) continue;
+
+            double reference;
+            if (runBackend(i, band, point1, point2, reference) && reference > 0) {
+                BackendBandStats& stats = backends[index].bandStats[band];
+                stats.calibrations++;
+                stats.totalRelativeError += std::abs(distance - reference) / reference;
+            }
+            return;
+        }
+    }
+};
+
+#endif // DISTANCE_QUERY_PLANNER_H
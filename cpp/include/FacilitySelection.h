@@ -0,0 +1,395 @@
+#ifndef FACILITY_SELECTION_H
+#define FACILITY_SELECTION_H
+
+#include <vector>
+#include <map>
+#include <queue>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include "CandidateDistanceMatrix.h"
+
+/**
+ * Choose which k of N candidate sites to open (p-median with capacities).
+ *
+ * Every person keeps its nearest and second-nearest open site (d1, d2)
+ * among its sparse candidate sites, and every open site keeps the cost of
+ * closing it: the sum of d2 - d1 over the people it serves. With those
+ * caches, opening a site f and closing a site r is priced by one pass over
+ * the people that list f as a candidate, plus O(k) to pick the best r
+ * (fast interchange after Whitaker / Resende-Werneck); only people near f
+ * or r are re-cached after a swap. A person with no open candidate costs a
+ * fixed unserved penalty.
+ *
+ * Sites are first opened by lazy greedy-add: a site's gain only shrinks as
+ * other sites open, so stale gains in a max-heap are upper bounds and only
+ * the top is re-evaluated. A site's gain counts at most its capacity of
+ * improved people, and an interchange never drops the open capacity below
+ * the number of people once it covers them. The exact capacitated cost of
+ * the chosen sites comes from running an assignment engine over them.
+ */
+class FacilitySelection {
+public:
+    using CandidateList = std::function<const std::vector<DistanceCandidate>&(int)>;
+
+private:
+    static constexpr size_t PARALLEL_SWAP_THRESHOLD = 256; // Closed sites before swap evaluation is split
+    static constexpr double MIN_PROFIT = 1e-9; // km; smaller swap gains end the interchange
+
+    struct SwapMove {
+        double profit;
+        int insert;
+        int remove;
+
+        SwapMove() : profit(0.0), insert(-1), remove(-1) {}
+    };
+
+    size_t personCount;
+    size_t siteCount;
+    std::vector<int> capacity;
+    int threadCount;
+
+    // Candidate sites per person (ascending distance) and people per site
+    std::vector<size_t> personStart;
+    std::vector<int> candidateSite;
+    std::vector<float> candidateDistance;
+    std::vector<size_t> siteStart;
+    std::vector<int> sitePerson;
+    std::vector<float> siteDistance;
+    double unservedPenalty;
+
+    std::vector<char> isOpen;
+    std::vector<int> openSites;
+    long long openCapacity;
+    std::vector<int> nearest; // Nearest open candidate site, -1 if none
+    std::vector<int> secondNearest;
+    std::vector<double> nearestDistance; // unservedPenalty when none
+    std::vector<double> secondDistance;
+    std::vector<double> closeCost; // Per open site: sum of d2 - d1 over the people it serves
+    double totalCost;
+
+    std::map<std::string, double> stats;
+
+public:
+    /**
+     * @param people Number of people
+     * @param siteCapacities Capacity per candidate site (0 = never opened)
+     * @param candidatesOf Candidate sites of a person, ascending by distance
+     */
+    FacilitySelection(size_t people, const std::vector<int>& siteCapacities, CandidateList candidatesOf)
+        : personCount(people)
+        , siteCount(siteCapacities.size())
+        , capacity(siteCapacities)
+        , threadCount(std::max(1u, std::thread::hardware_concurrency()))
+        , unservedPenalty(0.0)
+        , openCapacity(0)
+        , totalCost(0.0) {
+
+        // Flatten candidate lists and invert them into per-site people lists
+        personStart.assign(personCount + 1, 0);
+        std::vector<size_t> siteFill(siteCount + 1, 0);
+        double maxDistance = 0.0;
+        for (size_t i = 0; i < personCount; i++) {
+            for (const DistanceCandidate& candidate : candidatesOf(i)) {
+                if (capacity[candidate.centerIndex] <= 0) continue;
+                candidateSite.push_back(candidate.centerIndex);
+                candidateDistance.push_back(static_cast<float>(candidate.distance));
+                siteFill[candidate.centerIndex + 1]++;
+                maxDistance = std::max(maxDistance, candidate.distance);
+            }
+            personStart[i + 1] = candidateSite.size();
+        }
+        unservedPenalty = 2.0 * maxDistance + 1.0;
+
+        for (size_t j = 0; j < siteCount; j++) {
+            siteFill[j + 1] += siteFill[j];
+        }
+        siteStart = siteFill;
+        sitePerson.resize(candidateSite.size());
+        siteDistance.resize(candidateSite.size());
+        for (size_t i = 0; i < personCount; i++) {
+            for (size_t e = personStart[i]; e < personStart[i + 1]; e++) {
+                size_t slot = siteFill[candidateSite[e]]++;
+                sitePerson[slot] = static_cast<int>(i);
+                siteDistance[slot] = candidateDistance[e];
+            }
+        }
+    }
+
+    /**
+     * Set number of threads pricing swaps
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void setThreadCount(int threads) {
+        threadCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Open sites by greedy-add, then improve by interchange
+     * @param openCount Sites to open
+     * @param budgetSeconds Interchange time budget (0 = until no swap improves)
+     * @return Opened site indices, ascending
+     */
+    std::vector<int> select(int openCount, double budgetSeconds = 0.0) {
+        auto start = std::chrono::steady_clock::now();
+        resetOpenSites();
+        stats.clear();
+
+        greedyAdd(openCount);
+        double greedyCost = totalCost;
+        auto greedyEnd = std::chrono::steady_clock::now();
+
+        long long passes = 0, swaps = 0;
+        while (budgetSeconds <= 0.0 ||
+               std::chrono::duration<double>(std::chrono::steady_clock::now() - greedyEnd).count() < budgetSeconds) {
+            passes++;
+            SwapMove move = bestSwap();
+            if (move.insert == -1 || move.profit <= MIN_PROFIT * std::max(1.0, totalCost)) break;
+            applySwap(move.insert, move.remove);
+            swaps++;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        long long unserved = 0;
+        for (size_t i = 0; i < personCount; i++) {
+            if (nearest[i] == -1) unserved++;
+        }
+        stats["sites"] = siteCount;
+        stats["people"] = personCount;
+        stats["open"] = openSites.size();
+        stats["open_capacity"] = openCapacity;
+        stats["candidate_arcs"] = candidateSite.size();
+        stats["greedy_km"] = greedyCost;
+        stats["final_km"] = totalCost;
+        stats["unserved"] = unserved;
+        stats["passes"] = passes;
+        stats["swaps"] = swaps;
+        stats["threads"] = threadCount;
+        stats["greedy_ms"] = std::chrono::duration<double, std::milli>(greedyEnd - start).count();
+        stats["interchange_ms"] = std::chrono::duration<double, std::milli>(end - greedyEnd).count();
+
+        std::vector<int> opened(openSites);
+        std::sort(opened.begin(), opened.end());
+        return opened;
+    }
+
+    /**
+     * Get the uncapacitated cost of the open sites
+     * @return Sum over people of the distance to the nearest open site
+     *         (unserved penalty when none is a candidate)
+     */
+    double getTotalCost() const {
+        return totalCost;
+    }
+
+    /**
+     * Get selection statistics
+     * @return Sizes, greedy and final cost, passes, swaps and timings
+     */
+    std::map<std::string, double> getSelectionStats() const {
+        return stats;
+    }
+
+private:
+    void resetOpenSites() {
+        isOpen.assign(siteCount, 0);
+        openSites.clear();
+        openCapacity = 0;
+        nearest.assign(personCount, -1);
+        secondNearest.assign(personCount, -1);
+        nearestDistance.assign(personCount, unservedPenalty);
+        secondDistance.assign(personCount, unservedPenalty);
+        closeCost.assign(siteCount, 0.0);
+        totalCost = unservedPenalty * personCount;
+    }
+
+    /**
+     * Gain of opening a site, counting at most its capacity of improved people
+     */
+    double openGain(int site, std::vector<double>& improvements) const {
+        improvements.clear();
+        for (size_t e = siteStart[site]; e < siteStart[site + 1]; e++) {
+            double improvement = nearestDistance[sitePerson[e]] - siteDistance[e];
+            if (improvement > 0) improvements.push_back(improvement);
+        }
+        size_t counted = std::min<size_t>(improvements.size(), capacity[site]);
+        if (counted < improvements.size()) {
+            std::nth_element(improvements.begin(), improvements.begin() + counted, improvements.end(),
+                             std::greater<double>());
+        }
+        double gain = 0.0;
+        for (size_t i = 0; i < counted; i++) {
+            gain += improvements[i];
+        }
+        return gain;
+    }
+
+    /**
+     * Lazy greedy-add: pop the best stale gain, re-evaluate it, and open the
+     * site once its gain is current
+     */
+    void greedyAdd(int openCount) {
+        using Entry = std::pair<double, std::pair<int, int>>; // (gain, (site, sites open when computed))
+        std::priority_queue<Entry> heap;
+        std::vector<double> improvements;
+        for (size_t j = 0; j < siteCount; j++) {
+            if (capacity[j] > 0) {
+                heap.push({openGain(j, improvements), {static_cast<int>(j), 0}});
+            }
+        }
+
+        while (static_cast<int>(openSites.size()) < openCount && !heap.empty()) {
+            Entry top = heap.top();
+            heap.pop();
+            int site = top.second.first;
+            if (top.second.second != static_cast<int>(openSites.size())) {
+                heap.push({openGain(site, improvements), {site, static_cast<int>(openSites.size())}});
+                continue;
+            }
+            openSite(site);
+        }
+    }
+
+    void openSite(int site) {
+        isOpen[site] = 1;
+        openSites.push_back(site);
+        openCapacity += capacity[site];
+        for (size_t e = siteStart[site]; e < siteStart[site + 1]; e++) {
+            refreshPerson(sitePerson[e]);
+        }
+    }
+
+    void applySwap(int insert, int remove) {
+        isOpen[remove] = 0;
+        openSites.erase(std::find(openSites.begin(), openSites.end(), remove));
+        openCapacity -= capacity[remove];
+        for (size_t e = siteStart[remove]; e < siteStart[remove + 1]; e++) {
+            int person = sitePerson[e];
+            if (nearest[person] == remove || secondNearest[person] == remove) {
+                refreshPerson(person);
+            }
+        }
+        closeCost[remove] = 0.0;
+        openSite(insert);
+    }
+
+    /**
+     * Recompute a person's two nearest open sites and its share of the
+     * close cost and total cost
+     */
+    void refreshPerson(int person) {
+        if (nearest[person] != -1) {
+            closeCost[nearest[person]] -= secondDistance[person] - nearestDistance[person];
+        }
+        totalCost -= nearestDistance[person];
+
+        nearest[person] = secondNearest[person] = -1;
+        nearestDistance[person] = secondDistance[person] = unservedPenalty;
+        for (size_t e = personStart[person]; e < personStart[person + 1]; e++) {
+            if (!isOpen[candidateSite[e]]) continue;
+            if (nearest[person] == -1) {
+                nearest[person] = candidateSite[e];
+                nearestDistance[person] = candidateDistance[e];
+            } else {
+                secondNearest[person] = candidateSite[e];
+                secondDistance[person] = candidateDistance[e];
+                break;
+            }
+        }
+
+        if (nearest[person] != -1) {
+            closeCost[nearest[person]] += secondDistance[person] - nearestDistance[person];
+        }
+        totalCost += nearestDistance[person];
+    }
+
+    /**
+     * Price the best swap for each closed site and keep the best overall
+     */
+    SwapMove bestSwap() {
+        std::vector<int> closed;
+        for (size_t j = 0; j < siteCount; j++) {
+            if (!isOpen[j] && capacity[j] > 0) closed.push_back(j);
+        }
+        if (closed.empty() || openSites.empty()) return SwapMove();
+
+        int threads = std::min<int>(threadCount, static_cast<int>(closed.size() / (PARALLEL_SWAP_THRESHOLD / 2)));
+        if (closed.size() < PARALLEL_SWAP_THRESHOLD || threads < 2) {
+            return bestSwapIn(closed, 0, closed.size());
+        }
+
+        std::vector<SwapMove> best(threads);
+        std::vector<std::thread> workers;
+        size_t chunk = (closed.size() + threads - 1) / threads;
+        for (int t = 0; t < threads; t++) {
+            size_t begin = t * chunk;
+            size_t end = std::min(begin + chunk, closed.size());
+            workers.emplace_back([this, &closed, &best, t, begin, end]() {
+                best[t] = bestSwapIn(closed, begin, end);
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        SwapMove move;
+        for (const SwapMove& candidate : best) {
+            if (candidate.insert != -1 && (move.insert == -1 || candidate.profit > move.profit)) {
+                move = candidate;
+            }
+        }
+        return move;
+    }
+
+    /**
+     * Opening f gains d1 - d(f) from every person closer to f. Closing r
+     * costs closeCost[r], less a correction for r's people that f now
+     * serves (d2 - d1) or serves better than their second site (d2 - d(f)).
+     */
+    SwapMove bestSwapIn(const std::vector<int>& closed, size_t begin, size_t end) const {
+        std::vector<double> correction(siteCount, 0.0);
+        std::vector<int> touched;
+        long long people = static_cast<long long>(personCount);
+        SwapMove best;
+
+        for (size_t c = begin; c < end; c++) {
+            int insert = closed[c];
+            double gain = 0.0;
+            for (size_t e = siteStart[insert]; e < siteStart[insert + 1]; e++) {
+                int person = sitePerson[e];
+                double distance = siteDistance[e];
+                int site = nearest[person];
+                if (distance < nearestDistance[person]) {
+                    gain += nearestDistance[person] - distance;
+                    if (site == -1) continue;
+                    if (correction[site] == 0.0) touched.push_back(site);
+                    correction[site] += secondDistance[person] - nearestDistance[person];
+                } else if (distance < secondDistance[person] && site != -1) {
+                    if (correction[site] == 0.0) touched.push_back(site);
+                    correction[site] += secondDistance[person] - distance;
+                }
+            }
+
+            for (int remove : openSites) {
+                long long capacityAfter = openCapacity - capacity[remove] + capacity[insert];
+                if (capacityAfter < people && capacityAfter < openCapacity) continue;
+                double profit = gain - closeCost[remove] + correction[remove];
+                if (best.insert == -1 || profit > best.profit) {
+                    best.profit = profit;
+                    best.insert = insert;
+                    best.remove = remove;
+                }
+            }
+
+            for (int site : touched) {
+                correction[site] = 0.0;
+            }
+            touched.clear();
+        }
+        return best;
+    }
+};
+
+#endif // FACILITY_SELECTION_H
@@ -0,0 +1,330 @@
+#ifndef HTTP_TRANSPORT_H
+#define HTTP_TRANSPORT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <curl/curl.h>
+
+/**
+ * Performs HTTP GET requests for the routing backends. Implementations throw
+ * std::runtime_error on transport failure.
+ */
+class HttpTransport {
+public:
+    virtual ~HttpTransport() = default;
+
+    /**
+     * Fetch a URL
+     * @param url Request URL
+     * @return Response body
+     */
+    virtual std::string get(const std::string& url) = 0;
+
+    /**
+     * Create a transport with the same settings for use on another thread
+     * @return New transport, or null if every request must go through this
+     *         one (e.g. a single ordered record file)
+     */
+    virtual std::shared_ptr<HttpTransport> createWorker() const {
+        return nullptr;
+    }
+};
+
+/**
+ * libcurl transport used against live servers
+ */
+class CurlTransport : public HttpTransport {
+private:
+    CURL* curl;
+
+    // HTTP response callback for libcurl
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
+        size_t newLength = size * nmemb;
+        try {
+            s->append((char*)contents, newLength);
+            return newLength;
+        } catch(std::bad_alloc &e) {
+            return 0;
+        }
+    }
+
+public:
+    CurlTransport() : curl(nullptr) {
+        // Initialize libcurl
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        curl = curl_easy_init();
+
+        if (curl) {
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L); // 10 second timeout
+            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L); // 5 second connect timeout
+            curl_easy_setopt(curl, CURLOPT_USERAGENT, "RouteAnalyzer/1.0");
+        }
+    }
+
+    ~CurlTransport() override {
+        if (curl) {
+            curl_easy_cleanup(curl);
+        }
+        curl_global_cleanup();
+    }
+
+    CurlTransport(const CurlTransport&) = delete;
+    CurlTransport& operator=(const CurlTransport&) = delete;
+
+    std::shared_ptr<HttpTransport> createWorker() const override {
+        return std::make_shared<CurlTransport>();
+    }
+
+    std::string get(const std::string& url) override {
+        if (!curl) {
+            throw std::runtime_error("CURL not initialized");
+        }
+
+        std::string response;
+
+        // Set up CURL request
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+
+        // Perform the request
+        CURLcode res = curl_easy_perform(curl);
+
+        if (res != CURLE_OK) {
+            throw std::runtime_error("CURL error: " + std::string(curl_easy_strerror(res)));
+        }
+
+        return response;
+    }
+};
+
+/**
+ * Record file format, one record per request:
+ *   uint8  status   (0 = response, 1 = transport error message)
+ *   uint32 urlLength,  url bytes
+ *   uint32 bodyLength, body bytes
+ * Lengths are little-endian regardless of the host, so record files move
+ * between machines.
+ */
+struct TransportRecord {
+    std::string url;
+    std::string body;
+    bool failed;
+
+    static void writeLength(std::ostream& output, uint32_t length) {
+        char bytes[4];
+        for (int i = 0; i < 4; i++) {
+            bytes[i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+        }
+        output.write(bytes, sizeof(bytes));
+    }
+
+    static bool readLength(std::istream& input, uint32_t& length) {
+        unsigned char bytes[4];
+        if (!input.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) return false;
+        length = 0;
+        for (int i = 0; i < 4; i++) {
+            length |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+        }
+        return true;
+    }
+};
+
+/**
+ * Forwards requests to another transport and appends every request/response
+ * pair (including failures) to a record file
+ */
+class RecordingTransport : public HttpTransport {
+private:
+    std::shared_ptr<HttpTransport> inner;
+    std::ofstream output;
+    long long recordedCount;
+
+public:
+    /**
+     * @param transport Transport performing the real requests
+     * @param path Record file (appended to)
+     */
+    RecordingTransport(std::shared_ptr<HttpTransport> transport, const std::string& path)
+        : inner(transport), output(path, std::ios::binary | std::ios::app), recordedCount(0) {
+        if (!output) {
+            throw std::runtime_error("Cannot open transport record file: " + path);
+        }
+    }
+
+    std::string get(const std::string& url) override {
+        try {
+            std::string response = inner->get(url);
+            writeRecord(url, response, false);
+            return response;
+        } catch (const std::exception& e) {
+            writeRecord(url, e.what(), true);
+            throw;
+        }
+    }
+
+    long long getRecordedCount() const {
+        return recordedCount;
+    }
+
+private:
+    void writeRecord(const std::string& url, const std::string& body, bool failed) {
+        uint8_t status = failed ? 1 : 0;
+        uint32_t urlLength = url.size();
+        uint32_t bodyLength = body.size();
+
+        output.write(reinterpret_cast<const char*>(&status), sizeof(status));
+        TransportRecord::writeLength(output, urlLength);
+        output.write(url.data(), urlLength);
+        TransportRecord::writeLength(output, bodyLength);
+        output.write(body.data(), bodyLength);
+        output.flush();
+        recordedCount++;
+    }
+};
+
+/**
+ * Latency injected by the replay transport
+ */
+struct LatencyModel {
+    enum class Kind { None, Fixed, Uniform, LogNormal };
+
+    Kind kind;
+    double first;  // Fixed: latency; Uniform: min; LogNormal: median (all ms)
+    double second; // Uniform: max (ms); LogNormal: sigma of the underlying normal
+
+    LatencyModel(Kind k = Kind::None, double a = 0.0, double b = 0.0) : kind(k), first(a), second(b) {}
+
+    static LatencyModel fixed(double ms) { return LatencyModel(Kind::Fixed, ms); }
+    static LatencyModel uniform(double minMs, double maxMs) { return LatencyModel(Kind::Uniform, minMs, maxMs); }
+    static LatencyModel logNormal(double medianMs, double sigma) { return LatencyModel(Kind::LogNormal, medianMs, sigma); }
+};
+
+/**
+ * Serves responses from a record file without touching the network.
+ * Repeated requests for the same URL cycle through its recorded responses,
+ * and recorded failures are rethrown. Reading stops at a torn trailing
+ * record or at a length running past the end of the file.
+ */
+class ReplayTransport : public HttpTransport {
+private:
+    struct ReplayEntry {
+        std::vector<TransportRecord> records;
+        size_t next;
+    };
+
+    std::unordered_map<std::string, ReplayEntry> entries;
+    LatencyModel latencyModel;
+    std::mt19937 generator;
+    long long replayedCount;
+    long long missCount;
+
+public:
+    /**
+     * @param path Record file written by RecordingTransport
+     * @param latency Latency added to every replayed request
+     * @param seed Seed for latency sampling
+     */
+    ReplayTransport(const std::string& path, LatencyModel latency = LatencyModel(), unsigned int seed = 42)
+        : latencyModel(latency), generator(seed), replayedCount(0), missCount(0) {
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Cannot open transport record file: " + path);
+        }
+
+        input.seekg(0, std::ios::end);
+        std::streamoff fileSize = input.tellg();
+        input.seekg(0, std::ios::beg);
+
+        TransportRecord record;
+        while (readRecord(input, fileSize, record)) {
+            ReplayEntry& entry = entries[record.url];
+            entry.next = 0;
+            entry.records.push_back(record);
+        }
+    }
+
+    std::string get(const std::string& url) override {
+        injectLatency();
+
+        auto it = entries.find(url);
+        if (it == entries.end()) {
+            missCount++;
+            throw std::runtime_error("No recorded response for " + url);
+        }
+
+        ReplayEntry& entry = it->second;
+        const TransportRecord& record = entry.records[entry.next];
+        entry.next = (entry.next + 1) % entry.records.size();
+        replayedCount++;
+
+        if (record.failed) {
+            throw std::runtime_error(record.body);
+        }
+        return record.body;
+    }
+
+    /**
+     * Set latency injected per request
+     * @param latency Latency model
+     */
+    void setLatencyModel(const LatencyModel& latency) {
+        latencyModel = latency;
+    }
+
+    size_t getRecordedUrlCount() const { return entries.size(); }
+    long long getReplayedCount() const { return replayedCount; }
+    long long getMissCount() const { return missCount; }
+
+private:
+    /**
+     * Read one record, refusing lengths larger than the rest of the file
+     * before allocating for them
+     */
+    static bool readRecord(std::ifstream& input, std::streamoff fileSize, TransportRecord& record) {
+        uint8_t status;
+        uint32_t urlLength, bodyLength;
+
+        if (!input.read(reinterpret_cast<char*>(&status), sizeof(status))) return false;
+        if (!TransportRecord::readLength(input, urlLength) || urlLength > fileSize - input.tellg()) return false;
+        record.url.resize(urlLength);
+        if (!input.read(&record.url[0], urlLength)) return false;
+        if (!TransportRecord::readLength(input, bodyLength) || bodyLength > fileSize - input.tellg()) return false;
+        record.body.resize(bodyLength);
+        if (bodyLength > 0 && !input.read(&record.body[0], bodyLength)) return false;
+        record.failed = status != 0;
+        return true;
+    }
+
+    void injectLatency() {
+        double delayMs = 0.0;
+        switch (latencyModel.kind) {
+            case LatencyModel::Kind::None:
+                return;
+            case LatencyModel::Kind::Fixed:
+                delayMs = latencyModel.first;
+                break;
+            case LatencyModel::Kind::Uniform:
+                delayMs = std::uniform_real_distribution<double>(latencyModel.first, latencyModel.second)(generator);
+                break;
+            case LatencyModel::Kind::LogNormal:
+                delayMs = std::lognormal_distribution<double>(std::log(std::max(latencyModel.first, 1e-3)),
+                                                              latencyModel.second)(generator);
+                break;
+        }
+        if (delayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(delayMs));
+        }
+    }
+};
+
+#endif // HTTP_TRANSPORT_H
@@ -0,0 +1,577 @@
+#ifndef INCREMENTAL_ASSIGNMENT_H
+#define INCREMENTAL_ASSIGNMENT_H
+
+#include <vector>
+#include <map>
+#include <set>
+#include <queue>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include "CandidateDistanceMatrix.h"
+#include "CenterSpatialIndex.h"
+
+/**
+ * Keeps an assignment up to date while people come and go and center
+ * capacities change, repairing it locally instead of starting over.
+ *
+ * A new (or displaced) person is placed along a shortest augmenting path in
+ * the residual graph: the person takes a candidate center, whose occupant
+ * moves on to one of its own candidates, and so on until a center with a
+ * free unit is reached. Path cost is the total change in distance. People of
+ * a higher priority tier are never moved for a lower tier; if nothing is
+ * free, a person of a lower tier may be evicted instead, and is then placed
+ * the same way (or waits). A freed unit goes to the best waiting person, or
+ * else pulls in neighbors that are closer to it than to their own center.
+ *
+ * Candidate lists are built on first use from the k nearest centers, so an
+ * update only evaluates distances for the people it actually touches.
+ */
+class IncrementalAssignment {
+public:
+    using DistanceFunction = std::function<double(const Point&, const Point&)>;
+
+private:
+    static constexpr size_t MAX_SEARCH_CENTERS = 512; // Centers settled per augmenting path search
+    static constexpr int MAX_IMPROVEMENT_MOVES = 64;  // Moves pulled into one freed unit
+    static constexpr int NEIGHBOR_CENTERS = 8;        // Centers whose members may take a freed unit
+    static constexpr double EVICTION_PENALTY = 1e9;   // Any free unit beats evicting someone
+
+    std::vector<Point> testCenters;
+    DistanceFunction exactDistance;
+    CenterSpatialIndex spatialIndex;
+    int candidateCount;
+    int tierCount;
+
+    std::vector<Point> people;
+    std::vector<int> tier;
+    std::vector<char> active;
+    std::vector<int> assignedCenter;      // -1 if waiting or removed
+    std::vector<double> assignedDistance; // km
+    std::vector<std::vector<DistanceCandidate>> candidates; // Built lazily, sorted by distance
+    std::vector<int> fetchedCount;
+
+    std::vector<int> capacity;
+    std::vector<std::vector<int>> members; // Center -> assigned people
+    std::vector<int> memberSlot;           // Person -> position in its center's members
+    std::vector<std::set<int>> waiting;    // Tier -> unassigned people
+    std::vector<int> assignedPerTier;
+    long long freeUnits;
+
+    std::vector<int> changedPeople; // People whose center changed in the last update
+
+    long long updates;
+    long long searches;
+    long long settledCenters;
+    long long moves;
+    long long evictions;
+    long long evaluatedPairs;
+
+    struct SearchEntry {
+        double cost;     // Total change in distance along the chain
+        int center;
+        int fromCenter;  // -1 for the person being placed
+        int person;      // Person entering center (or being evicted from it)
+        double distance; // Distance of person to center
+        bool eviction;
+
+        bool operator>(const SearchEntry& other) const {
+            return cost > other.cost;
+        }
+    };
+
+    struct SettledCenter {
+        int fromCenter;
+        int person;
+        double distance; // Distance of person to this center
+    };
+
+public:
+    /**
+     * @param centers Test centers
+     * @param capacities Capacity of each center
+     * @param distanceFn Exact (road) distance function
+     * @param k Candidates fetched per person at a time
+     * @param tiers Number of priority tiers (tier 0 is served first)
+     */
+    IncrementalAssignment(const std::vector<Point>& centers, const std::vector<int>& capacities,
+                          DistanceFunction distanceFn, int k = 8, int tiers = 4)
+        : testCenters(centers)
+        , exactDistance(distanceFn)
+        , spatialIndex(centers)
+        , candidateCount(std::max(k, 1))
+        , tierCount(std::max(tiers, 1))
+        , capacity(capacities)
+        , members(centers.size())
+        , waiting(std::max(tiers, 1))
+        , assignedPerTier(std::max(tiers, 1), 0)
+        , freeUnits(0)
+        , updates(0)
+        , searches(0)
+        , settledCenters(0)
+        , moves(0)
+        , evictions(0)
+        , evaluatedPairs(0) {
+
+        capacity.resize(centers.size(), 0);
+        for (int& units : capacity) {
+            units = std::max(units, 0);
+            freeUnits += units;
+        }
+    }
+
+    /**
+     * Load a person with an existing assignment, without repairing anything
+     * @param person Person
+     * @param personTier Priority tier
+     * @param centerIndex Assigned center or -1
+     * @param distance Distance to the assigned center in km
+     * @return Person index
+     */
+    int seedPerson(const Point& person, int personTier, int centerIndex, double distance) {
+        int personIndex = appendPerson(person, personTier);
+        if (centerIndex >= 0 && static_cast<int>(members[centerIndex].size()) < capacity[centerIndex]) {
+            attach(personIndex, centerIndex, distance);
+        } else {
+            waiting[tier[personIndex]].insert(personIndex);
+        }
+        return personIndex;
+    }
+
+    /**
+     * Add a person and place them by a shortest augmenting path
+     * @param person Person
+     * @param personTier Priority tier
+     * @return Person index
+     */
+    int addPerson(const Point& person, int personTier) {
+        beginUpdate();
+        int personIndex = appendPerson(person, personTier);
+        place(personIndex);
+        return personIndex;
+    }
+
+    /**
+     * Remove a person and hand their unit to someone else
+     * @param personIndex Person index
+     * @return False if the person does not exist or was already removed
+     */
+    bool removePerson(int personIndex) {
+        if (personIndex < 0 || personIndex >= static_cast<int>(people.size()) || !active[personIndex]) {
+            return false;
+        }
+        beginUpdate();
+        active[personIndex] = 0;
+
+        int centerIndex = assignedCenter[personIndex];
+        if (centerIndex == -1) {
+            waiting[tier[personIndex]].erase(personIndex);
+            return true;
+        }
+
+        detach(personIndex);
+        changedPeople.push_back(personIndex);
+        fillFreeUnits(centerIndex);
+        return true;
+    }
+
+    /**
+     * Change the capacity of a center; extra units are filled and any
+     * overflow is moved elsewhere, lowest priority first
+     * @param centerIndex Center index
+     * @param newCapacity New capacity
+     */
+    void setCenterCapacity(int centerIndex, int newCapacity) {
+        beginUpdate();
+        newCapacity = std::max(newCapacity, 0);
+        int load = static_cast<int>(members[centerIndex].size());
+        freeUnits += std::max(newCapacity - load, 0) - std::max(capacity[centerIndex] - load, 0);
+        capacity[centerIndex] = newCapacity;
+
+        if (load < newCapacity) {
+            fillFreeUnits(centerIndex);
+            return;
+        }
+
+        // Shed lowest priority first, and within a tier the farthest
+        std::vector<int> overflow = members[centerIndex];
+        std::sort(overflow.begin(), overflow.end(), [this](int a, int b) {
+            if (tier[a] != tier[b]) return tier[a] > tier[b];
+            return assignedDistance[a] > assignedDistance[b];
+        });
+        overflow.resize(load - newCapacity);
+
+        for (int personIndex : overflow) {
+            detach(personIndex);
+            changedPeople.push_back(personIndex);
+        }
+        std::sort(overflow.begin(), overflow.end(), [this](int a, int b) {
+            return tier[a] != tier[b] ? tier[a] < tier[b] : a < b;
+        });
+        for (int personIndex : overflow) {
+            place(personIndex);
+        }
+    }
+
+    /**
+     * Get assigned center of a person
+     * @param personIndex Person index
+     * @return Center index or -1
+     */
+    int getAssignedCenter(int personIndex) const {
+        return assignedCenter[personIndex];
+    }
+
+    /**
+     * Get distance of a person's assignment
+     * @param personIndex Person index
+     * @return Distance in km (0 if unassigned)
+     */
+    double getAssignedDistance(int personIndex) const {
+        return assignedDistance[personIndex];
+    }
+
+    /**
+     * Get a person
+     * @param personIndex Person index
+     * @return Person as added (removed people included)
+     */
+    const Point& getPerson(int personIndex) const {
+        return people[personIndex];
+    }
+
+    /**
+     * Check whether a person is still present
+     * @param personIndex Person index
+     * @return False once removed
+     */
+    bool isActive(int personIndex) const {
+        return active[personIndex] != 0;
+    }
+
+    /**
+     * Get people whose assignment changed in the last update
+     * @return Person indices (removed people included)
+     */
+    const std::vector<int>& getChangedPeople() const {
+        return changedPeople;
+    }
+
+    /**
+     * Get free units of a center
+     * @param centerIndex Center index
+     * @return Remaining capacity
+     */
+    int getRemainingCapacity(int centerIndex) const {
+        return std::max(capacity[centerIndex] - static_cast<int>(members[centerIndex].size()), 0);
+    }
+
+    size_t getPersonCount() const {
+        return people.size();
+    }
+
+    /**
+     * Get repair statistics
+     * @return Update, search, move, eviction and evaluation counters
+     */
+    std::map<std::string, long long> getRepairStats() const {
+        std::map<std::string, long long> stats;
+        stats["updates"] = updates;
+        stats["searches"] = searches;
+        stats["settled_centers"] = settledCenters;
+        stats["moves"] = moves;
+        stats["evictions"] = evictions;
+        stats["evaluated_pairs"] = evaluatedPairs;
+        long long waitingPeople = 0;
+        for (const std::set<int>& tierWaiting : waiting) {
+            waitingPeople += tierWaiting.size();
+        }
+        stats["waiting"] = waitingPeople;
+        return stats;
+    }
+
+private:
+    void beginUpdate() {
+        changedPeople.clear();
+        updates++;
+    }
+
+    int appendPerson(const Point& person, int personTier) {
+        int personIndex = static_cast<int>(people.size());
+        people.push_back(person);
+        tier.push_back(std::min(std::max(personTier, 0), tierCount - 1));
+        active.push_back(1);
+        assignedCenter.push_back(-1);
+        assignedDistance.push_back(0.0);
+        candidates.emplace_back();
+        fetchedCount.push_back(0);
+        memberSlot.push_back(-1);
+        return personIndex;
+    }
+
+    void attach(int personIndex, int centerIndex, double distance) {
+        if (static_cast<int>(members[centerIndex].size()) < capacity[centerIndex]) {
+            freeUnits--;
+        }
+        memberSlot[personIndex] = static_cast<int>(members[centerIndex].size());
+        members[centerIndex].push_back(personIndex);
+        assignedCenter[personIndex] = centerIndex;
+        assignedDistance[personIndex] = distance;
+        assignedPerTier[tier[personIndex]]++;
+    }
+
+    void detach(int personIndex) {
+        int centerIndex = assignedCenter[personIndex];
+        std::vector<int>& centerMembers = members[centerIndex];
+        int slot = memberSlot[personIndex];
+        centerMembers[slot] = centerMembers.back();
+        memberSlot[centerMembers[slot]] = slot;
+        centerMembers.pop_back();
+        if (static_cast<int>(centerMembers.size()) < capacity[centerIndex]) {
+            freeUnits++;
+        }
+
+        memberSlot[personIndex] = -1;
+        assignedCenter[personIndex] = -1;
+        assignedDistance[personIndex] = 0.0;
+        assignedPerTier[tier[personIndex]]--;
+    }
+
+    void moveTo(int personIndex, int centerIndex, double distance) {
+        if (assignedCenter[personIndex] != -1) {
+            detach(personIndex);
+        } else {
+            waiting[tier[personIndex]].erase(personIndex);
+        }
+        attach(personIndex, centerIndex, distance);
+        changedPeople.push_back(personIndex);
+        moves++;
+    }
+
+    /**
+     * Get a person's candidates, fetching the first k on first use
+     */
+    const std::vector<DistanceCandidate>& candidatesOf(int personIndex) {
+        if (fetchedCount[personIndex] == 0) {
+            extendCandidates(personIndex);
+        }
+        return candidates[personIndex];
+    }
+
+    /**
+     * Fetch the next k nearest centers of a person
+     * @return False if the list already holds every center
+     */
+    bool extendCandidates(int personIndex) {
+        int previous = fetchedCount[personIndex];
+        if (previous >= static_cast<int>(testCenters.size())) return false;
+
+        int target = std::min(previous + candidateCount, static_cast<int>(testCenters.size()));
+        std::vector<int> nearest = spatialIndex.findNearest(people[personIndex], target);
+
+        std::vector<DistanceCandidate>& list = candidates[personIndex];
+        for (size_t i = previous; i < nearest.size(); i++) {
+            list.emplace_back(nearest[i], exactDistance(people[personIndex], testCenters[nearest[i]]));
+            evaluatedPairs++;
+        }
+        std::sort(list.begin(), list.end(), [](const DistanceCandidate& a, const DistanceCandidate& b) {
+            return a.distance < b.distance;
+        });
+        fetchedCount[personIndex] = target;
+        return true;
+    }
+
+    /**
+     * Whether placing a person of this tier can succeed at all
+     */
+    bool hasRoomFor(int personTier) const {
+        if (freeUnits > 0) return true;
+        for (int lower = personTier + 1; lower < tierCount; lower++) {
+            if (assignedPerTier[lower] > 0) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Place an unassigned person, extending their candidates until an
+     * augmenting path is found; evicted people are placed in turn
+     */
+    void place(int personIndex) {
+        std::vector<int> pending(1, personIndex);
+
+        while (!pending.empty()) {
+            // Evictees are of strictly lower tiers, so this terminates
+            int current = pending.back();
+            pending.pop_back();
+
+            int evicted = -1;
+            bool placed = false;
+            while (hasRoomFor(tier[current])) {
+                if (augment(current, evicted)) {
+                    placed = true;
+                    break;
+                }
+                if (!extendCandidates(current)) break;
+            }
+
+            if (!placed) {
+                waiting[tier[current]].insert(current);
+                continue;
+            }
+            if (evicted != -1) {
+                evictions++;
+                pending.push_back(evicted);
+            }
+        }
+    }
+
+    /**
+     * Best-first search for the cheapest chain of moves ending at a free
+     * unit (or at an eviction of a lower tier), then apply it
+     * @param personIndex Unassigned person to place
+     * @param evicted Set to the evicted person, if any
+     * @return False if no chain was found within the candidate lists
+     */
+    bool augment(int personIndex, int& evicted) {
+        searches++;
+        int personTier = tier[personIndex];
+
+        std::priority_queue<SearchEntry, std::vector<SearchEntry>, std::greater<SearchEntry>> frontier;
+        std::unordered_map<int, SettledCenter> settled;
+
+        for (const DistanceCandidate& candidate : candidatesOf(personIndex)) {
+            frontier.push({candidate.distance, candidate.centerIndex, -1, personIndex, candidate.distance, false});
+        }
+
+        while (!frontier.empty()) {
+            SearchEntry entry = frontier.top();
+            frontier.pop();
+
+            if (entry.eviction) {
+                // The center is settled; its unit goes to the chain, the occupant waits
+                detach(entry.person);
+                changedPeople.push_back(entry.person);
+                applyChain(entry.center, settled);
+                evicted = entry.person;
+                return true;
+            }
+
+            if (settled.count(entry.center)) continue;
+            settled[entry.center] = {entry.fromCenter, entry.person, entry.distance};
+            settledCenters++;
+
+            if (static_cast<int>(members[entry.center].size()) < capacity[entry.center]) {
+                applyChain(entry.center, settled);
+                return true;
+            }
+            if (settled.size() >= MAX_SEARCH_CENTERS) continue;
+
+            // Occupants of the same or lower priority may move on
+            for (int occupant : members[entry.center]) {
+                if (tier[occupant] < personTier) continue;
+                double base = entry.cost - assignedDistance[occupant];
+                for (const DistanceCandidate& candidate : candidatesOf(occupant)) {
+                    if (candidate.centerIndex == entry.center || settled.count(candidate.centerIndex)) continue;
+                    frontier.push({base + candidate.distance, candidate.centerIndex, entry.center,
+                                   occupant, candidate.distance, false});
+                }
+                if (tier[occupant] > personTier) {
+                    frontier.push({entry.cost + EVICTION_PENALTY, entry.center, entry.center,
+                                   occupant, 0.0, true});
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Move every person on the chain ending at a center one step forward,
+     * last move first so each center frees its unit before it is reused
+     */
+    void applyChain(int endCenter, const std::unordered_map<int, SettledCenter>& settled) {
+        for (int center = endCenter; center != -1;) {
+            const SettledCenter& step = settled.at(center);
+            moveTo(step.person, center, step.distance);
+            center = step.fromCenter;
+        }
+    }
+
+    /**
+     * Use the free units of a center: first for the best waiting people,
+     * then for assigned neighbors that are closer to it than to their own
+     * center, following the chain of units each move frees
+     */
+    void fillFreeUnits(int centerIndex) {
+        while (getRemainingCapacity(centerIndex) > 0 && placeWaitingNear(centerIndex)) {}
+
+        int current = centerIndex;
+        for (int step = 0; step < MAX_IMPROVEMENT_MOVES && current != -1; step++) {
+            if (getRemainingCapacity(current) == 0) break;
+            current = pullCloserNeighbor(current);
+        }
+    }
+
+    /**
+     * Place the waiting person of the highest tier nearest to a center
+     * @return False if nobody is waiting or the placement failed
+     */
+    bool placeWaitingNear(int centerIndex) {
+        for (std::set<int>& tierWaiting : waiting) {
+            if (tierWaiting.empty()) continue;
+
+            int nearest = -1;
+            double nearestDistance = std::numeric_limits<double>::max();
+            for (int personIndex : tierWaiting) {
+                double distance = people[personIndex].distanceTo(testCenters[centerIndex]);
+                if (distance < nearestDistance) {
+                    nearestDistance = distance;
+                    nearest = personIndex;
+                }
+            }
+
+            tierWaiting.erase(nearest);
+            place(nearest);
+            return assignedCenter[nearest] != -1;
+        }
+        return false;
+    }
+
+    /**
+     * Move into a center with a free unit the neighbor that gains the most
+     * (highest tier first)
+     * @return Center the neighbor left, or -1 if nobody gains
+     */
+    int pullCloserNeighbor(int centerIndex) {
+        int bestPerson = -1;
+        double bestDistance = 0.0;
+        double bestGain = 0.0;
+
+        for (int neighbor : spatialIndex.findNearest(testCenters[centerIndex], NEIGHBOR_CENTERS + 1)) {
+            if (neighbor == centerIndex) continue;
+            for (int occupant : members[neighbor]) {
+                if (bestPerson != -1 && tier[occupant] > tier[bestPerson]) continue;
+                // Haversine is a lower bound on road distance
+                if (people[occupant].distanceTo(testCenters[centerIndex]) >= assignedDistance[occupant]) continue;
+
+                double distance = exactDistance(people[occupant], testCenters[centerIndex]);
+                evaluatedPairs++;
+                double gain = assignedDistance[occupant] - distance;
+                if (gain <= 0) continue;
+                if (bestPerson == -1 || tier[occupant] < tier[bestPerson] || gain > bestGain) {
+                    bestPerson = occupant;
+                    bestDistance = distance;
+                    bestGain = gain;
+                }
+            }
+        }
+
+        if (bestPerson == -1) return -1;
+        int leftCenter = assignedCenter[bestPerson];
+        moveTo(bestPerson, centerIndex, bestDistance);
+        return leftCenter;
+    }
+};
+
+#endif // INCREMENTAL_ASSIGNMENT_H
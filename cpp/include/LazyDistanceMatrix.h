@@ -0,0 +1,145 @@
+#ifndef LAZY_DISTANCE_MATRIX_H
+#define LAZY_DISTANCE_MATRIX_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include "RandomPointGenerator.h"
+#include "DistanceMatrix.h"
+
+/**
+ * Distance matrix that stores Haversine lower bounds up front and evaluates
+ * exact road distances only when a best-first search needs them.
+ *
+ * Road distance is never shorter than the straight-line distance, so once the
+ * best exact distance found for a person is no larger than the next candidate's
+ * lower bound, no remaining candidate can win and the search stops.
+ */
+class LazyDistanceMatrix {
+private:
+    static constexpr float NOT_EVALUATED = -1.0f;
+
+    const std::vector<Point>& people;
+    const std::vector<Point>& testCenters;
+    std::function<double(const Point&, const Point&)> exactDistance;
+    DistanceMatrix lowerBounds;
+    DistanceMatrix exact; // NOT_EVALUATED until computed
+    std::vector<std::vector<int>> candidateOrder; // Centers by ascending lower bound, built on demand
+    long long evaluatedPairs;
+
+public:
+    /**
+     * Build lower bounds for all pairs
+     * @param p People (must outlive the matrix)
+     * @param c Test centers (must outlive the matrix)
+     * @param exactFn Exact (road) distance function
+     */
+    LazyDistanceMatrix(const std::vector<Point>& p, const std::vector<Point>& c,
+                       std::function<double(const Point&, const Point&)> exactFn)
+        : people(p)
+        , testCenters(c)
+        , exactDistance(exactFn)
+        , lowerBounds(p.size(), c.size())
+        , exact(p.size(), c.size())
+        , candidateOrder(p.size())
+        , evaluatedPairs(0) {
+
+        for (size_t i = 0; i < people.size(); i++) {
+            float* bounds = lowerBounds.floatRow(i);
+            float* values = exact.floatRow(i);
+            for (size_t j = 0; j < testCenters.size(); j++) {
+                bounds[j] = people[i].distanceTo(testCenters[j]);
+                values[j] = NOT_EVALUATED;
+            }
+        }
+    }
+
+    /**
+     * Get exact distance, evaluating it if needed
+     * @param personIndex Person index
+     * @param centerIndex Center index
+     * @return Exact distance in kilometers
+     */
+    double getExact(int personIndex, int centerIndex) {
+        float& value = exact.floatRow(personIndex)[centerIndex];
+        if (value == NOT_EVALUATED) {
+            // Guard against backends that undershoot the straight-line bound
+            value = std::max<double>(exactDistance(people[personIndex], testCenters[centerIndex]),
+                                     lowerBounds.floatRow(personIndex)[centerIndex]);
+            evaluatedPairs++;
+        }
+        return value;
+    }
+
+    /**
+     * Get the straight-line lower bound for a pair
+     * @param personIndex Person index
+     * @param centerIndex Center index
+     * @return Lower bound in kilometers
+     */
+    double getLowerBound(int personIndex, int centerIndex) const {
+        return lowerBounds.floatRow(personIndex)[centerIndex];
+    }
+
+    /**
+     * Find the available center with the smallest exact distance, evaluating
+     * candidates in lower-bound order until no remaining bound can beat the best
+     * @param personIndex Person index
+     * @param isAvailable Predicate telling whether a center still has capacity
+     * @return Pair of (centerIndex, distance) or (-1, -1) if none available
+     */
+    std::pair<int, double> findBestAvailable(int personIndex, const std::function<bool(int)>& isAvailable) {
+        const std::vector<int>& order = getCandidateOrder(personIndex);
+
+        int bestCenter = -1;
+        double bestDistance = std::numeric_limits<double>::max();
+
+        for (int centerIndex : order) {
+            if (getLowerBound(personIndex, centerIndex) >= bestDistance) {
+                break;
+            }
+            if (!isAvailable(centerIndex)) {
+                continue;
+            }
+
+            double distance = getExact(personIndex, centerIndex);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                bestCenter = centerIndex;
+            }
+        }
+
+        return (bestCenter != -1) ? std::make_pair(bestCenter, bestDistance) : std::make_pair(-1, -1.0);
+    }
+
+    /**
+     * Get evaluation statistics
+     * @return Evaluated and total pair counts
+     */
+    std::map<std::string, long long> getEvaluationStats() const {
+        std::map<std::string, long long> stats;
+        stats["evaluated_pairs"] = evaluatedPairs;
+        stats["total_pairs"] = static_cast<long long>(people.size()) * testCenters.size();
+        return stats;
+    }
+
+private:
+    const std::vector<int>& getCandidateOrder(int personIndex) {
+        std::vector<int>& order = candidateOrder[personIndex];
+        if (order.empty() && !testCenters.empty()) {
+            order.resize(testCenters.size());
+            std::iota(order.begin(), order.end(), 0);
+            const float* bounds = lowerBounds.floatRow(personIndex);
+            std::sort(order.begin(), order.end(), [&bounds](int a, int b) {
+                return bounds[a] < bounds[b];
+            });
+        }
+        return order;
+    }
+};
+
+#endif // LAZY_DISTANCE_MATRIX_H
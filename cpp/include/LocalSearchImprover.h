@@ -0,0 +1,454 @@
+#ifndef LOCAL_SEARCH_IMPROVER_H
+#define LOCAL_SEARCH_IMPROVER_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "CenterSpatialIndex.h"
+
+enum class LocalSearchObjective {
+    TotalDistance, // Lower the distance sum of each tier
+    MaxDistance    // Lower the longest trip among the people a move touches
+};
+
+/**
+ * Improves a finished assignment with relocate, swap and ejection-chain
+ * moves inside spatial neighborhoods, until no move helps or a wall-clock
+ * budget runs out.
+ *
+ * Each person drives moves towards its k nearest centers it would gain
+ * from: relocate to a center with a free unit, swap with an occupant of
+ * that center, or push an occupant on to a free unit of one of the
+ * occupant's own neighbors. A move only changes the distances of the one or
+ * two people it touches, so its delta is evaluated in O(1). Moves are
+ * compared per priority tier, highest tier first, so no move may worsen a
+ * tier for the benefit of a lower one; capacities are never exceeded.
+ *
+ * Rounds evaluate every driver in parallel against a frozen state, then
+ * apply the best proposals serially, skipping any made stale by an earlier
+ * one.
+ */
+class LocalSearchImprover {
+public:
+    using DistanceLookup = std::function<double(int, int)>; // (personIndex, centerIndex) -> km
+
+private:
+    static constexpr int NEIGHBOR_CENTERS = 8;
+    static constexpr size_t PARALLEL_DRIVER_THRESHOLD = 2048; // Fewer drivers are evaluated serially
+    static constexpr size_t CLOCK_CHECK_INTERVAL = 256;       // Drivers between budget checks
+    static constexpr double MIN_GAIN = 1e-9;                  // km
+
+    enum class MoveType { Relocate, Swap, Ejection };
+
+    struct Move {
+        MoveType type;
+        int person;      // Driver, moves from -> to
+        int other;       // Occupant of 'to' (swap / ejection), else -1
+        int from;
+        int to;
+        int otherTo;     // Where the occupant goes: 'from' for a swap
+        double personDistance;
+        double otherDistance;
+        int keyTier;     // Highest tier the move changes
+        double keyValue; // Change for that tier (negative = better)
+    };
+
+    const std::vector<Point>& people;
+    const std::vector<Point>& testCenters;
+    std::vector<int> tier;
+    DistanceLookup distanceOf;
+    LocalSearchObjective objective;
+    int threadCount;
+
+    std::vector<int> assignedCenter;
+    std::vector<double> assignedDistance;
+    std::vector<int> freeUnits;
+    std::vector<std::vector<int>> members;
+    std::vector<int> memberSlot;
+    std::vector<int> neighbors; // NEIGHBOR_CENTERS per person
+
+    long long rounds;
+    long long evaluatedMoves;
+    long long relocates;
+    long long swaps;
+    long long ejections;
+    double initialTotal;
+    double initialMax;
+    double elapsedMs;
+
+public:
+    /**
+     * @param p People
+     * @param centers Test centers
+     * @param tiers Priority tier per person (0 is served first)
+     * @param centerOf Assigned center per person, -1 if unassigned
+     * @param distanceOfAssigned Distance per assigned person in km
+     * @param remainingCapacity Free units per center
+     * @param lookup Distance of any (person, center) pair in km
+     * @param goal Objective to improve
+     */
+    LocalSearchImprover(const std::vector<Point>& p, const std::vector<Point>& centers,
+                        const std::vector<int>& tiers, const std::vector<int>& centerOf,
+                        const std::vector<double>& distanceOfAssigned,
+                        const std::vector<int>& remainingCapacity, DistanceLookup lookup,
+                        LocalSearchObjective goal = LocalSearchObjective::TotalDistance)
+        : people(p)
+        , testCenters(centers)
+        , tier(tiers)
+        , distanceOf(lookup)
+        , objective(goal)
+        , threadCount(std::max(1u, std::thread::hardware_concurrency()))
+        , assignedCenter(centerOf)
+        , assignedDistance(distanceOfAssigned)
+        , freeUnits(remainingCapacity)
+        , members(centers.size())
+        , memberSlot(p.size(), -1)
+        , rounds(0)
+        , evaluatedMoves(0)
+        , relocates(0)
+        , swaps(0)
+        , ejections(0)
+        , initialTotal(0)
+        , initialMax(0)
+        , elapsedMs(0) {
+
+        for (int& units : freeUnits) {
+            units = std::max(units, 0);
+        }
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] == -1) continue;
+            memberSlot[i] = static_cast<int>(members[assignedCenter[i]].size());
+            members[assignedCenter[i]].push_back(i);
+        }
+        initialTotal = totalDistance();
+        initialMax = maxDistance();
+    }
+
+    /**
+     * Set number of threads evaluating moves
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void setThreadCount(int threads) {
+        threadCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int getThreadCount() const {
+        return threadCount;
+    }
+
+    /**
+     * Run improvement rounds until none helps or the budget is spent
+     * @param budgetSeconds Wall-clock budget
+     */
+    void improve(double budgetSeconds) {
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(std::max(budgetSeconds, 0.0)));
+
+        std::vector<int> drivers;
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] != -1) drivers.push_back(i);
+        }
+        if (!drivers.empty() && neighbors.empty()) {
+            buildNeighbors();
+        }
+
+        std::vector<char> changedCenter(testCenters.size(), 0);
+        while (!drivers.empty() && std::chrono::steady_clock::now() < deadline) {
+            std::vector<Move> proposals = proposeMoves(drivers, deadline);
+            rounds++;
+
+            std::fill(changedCenter.begin(), changedCenter.end(), 0);
+            if (applyMoves(proposals, changedCenter) == 0) break;
+
+            // Only people next to a center that changed can have a new move
+            drivers.clear();
+            for (size_t i = 0; i < people.size(); i++) {
+                if (assignedCenter[i] == -1) continue;
+                bool touched = changedCenter[assignedCenter[i]] != 0;
+                for (int n = 0; n < NEIGHBOR_CENTERS && !touched; n++) {
+                    int neighbor = neighbors[i * NEIGHBOR_CENTERS + n];
+                    touched = neighbor != -1 && changedCenter[neighbor];
+                }
+                if (touched) drivers.push_back(i);
+            }
+        }
+
+        elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * Get assigned center of a person
+     * @param personIndex Person index
+     * @return Center index or -1
+     */
+    int getAssignedCenter(int personIndex) const {
+        return assignedCenter[personIndex];
+    }
+
+    /**
+     * Get distance of a person's assignment
+     * @param personIndex Person index
+     * @return Distance in km
+     */
+    double getAssignedDistance(int personIndex) const {
+        return assignedDistance[personIndex];
+    }
+
+    /**
+     * Get free units per center after the moves
+     * @return Remaining capacity
+     */
+    const std::vector<int>& getRemainingCapacity() const {
+        return freeUnits;
+    }
+
+    /**
+     * Get improvement statistics
+     * @return Distances before and after, move counts, rounds and time
+     */
+    std::map<std::string, double> getImprovementStats() const {
+        std::map<std::string, double> stats;
+        stats["initial_total_km"] = initialTotal;
+        stats["final_total_km"] = totalDistance();
+        stats["initial_max_km"] = initialMax;
+        stats["final_max_km"] = maxDistance();
+        stats["relocates"] = static_cast<double>(relocates);
+        stats["swaps"] = static_cast<double>(swaps);
+        stats["ejections"] = static_cast<double>(ejections);
+        stats["rounds"] = static_cast<double>(rounds);
+        stats["evaluated_moves"] = static_cast<double>(evaluatedMoves);
+        stats["threads"] = threadCount;
+        stats["elapsed_ms"] = elapsedMs;
+        return stats;
+    }
+
+private:
+    double totalDistance() const {
+        double total = 0;
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] != -1) total += assignedDistance[i];
+        }
+        return total;
+    }
+
+    double maxDistance() const {
+        double longest = 0;
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] != -1) longest = std::max(longest, assignedDistance[i]);
+        }
+        return longest;
+    }
+
+    void buildNeighbors() {
+        CenterSpatialIndex spatialIndex(testCenters);
+        neighbors.assign(people.size() * NEIGHBOR_CENTERS, -1);
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] == -1) continue;
+            std::vector<int> nearest = spatialIndex.findNearest(people[i], NEIGHBOR_CENTERS);
+            std::copy(nearest.begin(), nearest.end(), neighbors.begin() + i * NEIGHBOR_CENTERS);
+        }
+    }
+
+    /**
+     * Rank the change of one or two people's distances: the highest tier
+     * touched decides; within it the distance sum (or the longest trip)
+     * must go down
+     * @return False if the move does not improve
+     */
+    bool rankMove(Move& move) const {
+        int personTier = tier[move.person];
+        double personOld = assignedDistance[move.person];
+        if (move.other == -1) {
+            move.keyTier = personTier;
+            move.keyValue = move.personDistance - personOld;
+            return move.keyValue < -MIN_GAIN;
+        }
+
+        int otherTier = tier[move.other];
+        double otherOld = assignedDistance[move.other];
+        double sumChange;
+        double maxChange;
+        if (personTier == otherTier) {
+            move.keyTier = personTier;
+            sumChange = (move.personDistance - personOld) + (move.otherDistance - otherOld);
+            maxChange = std::max(move.personDistance, move.otherDistance) - std::max(personOld, otherOld);
+        } else if (personTier < otherTier) {
+            move.keyTier = personTier;
+            sumChange = maxChange = move.personDistance - personOld;
+        } else {
+            move.keyTier = otherTier;
+            sumChange = maxChange = move.otherDistance - otherOld;
+        }
+
+        if (objective == LocalSearchObjective::MaxDistance && std::abs(maxChange) > MIN_GAIN) {
+            move.keyValue = maxChange;
+        } else {
+            move.keyValue = sumChange;
+        }
+        return move.keyValue < -MIN_GAIN;
+    }
+
+    static bool betterMove(const Move& a, const Move& b) {
+        return a.keyTier != b.keyTier ? a.keyTier < b.keyTier : a.keyValue < b.keyValue;
+    }
+
+    /**
+     * Find the best improving move driven by one person in the frozen state
+     * @return False if there is none
+     */
+    bool bestMoveFor(int person, Move& best, long long& evaluated) const {
+        bool found = false;
+        int from = assignedCenter[person];
+        double current = assignedDistance[person];
+
+        for (int n = 0; n < NEIGHBOR_CENTERS; n++) {
+            int to = neighbors[person * NEIGHBOR_CENTERS + n];
+            if (to == -1 || to == from) continue;
+            double personDistance = distanceOf(person, to);
+            if (personDistance >= current - MIN_GAIN) continue; // The driver must gain
+
+            Move move{MoveType::Relocate, person, -1, from, to, -1, personDistance, 0.0, 0, 0.0};
+            if (freeUnits[to] > 0) {
+                evaluated++;
+                if (rankMove(move) && (!found || betterMove(move, best))) {
+                    best = move;
+                    found = true;
+                }
+                continue; // A free unit beats displacing anyone
+            }
+
+            for (int other : members[to]) {
+                move.other = other;
+
+                move.type = MoveType::Swap;
+                move.otherTo = from;
+                move.otherDistance = distanceOf(other, from);
+                evaluated++;
+                if (rankMove(move) && (!found || betterMove(move, best))) {
+                    best = move;
+                    found = true;
+                }
+
+                move.type = MoveType::Ejection;
+                for (int m = 0; m < NEIGHBOR_CENTERS; m++) {
+                    int otherTo = neighbors[other * NEIGHBOR_CENTERS + m];
+                    if (otherTo == -1 || otherTo == to || otherTo == from || freeUnits[otherTo] <= 0) continue;
+                    move.otherTo = otherTo;
+                    move.otherDistance = distanceOf(other, otherTo);
+                    evaluated++;
+                    if (rankMove(move) && (!found || betterMove(move, best))) {
+                        best = move;
+                        found = true;
+                    }
+                }
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Evaluate all drivers against the current state, in parallel for
+     * large inputs
+     */
+    std::vector<Move> proposeMoves(const std::vector<int>& drivers,
+                                   std::chrono::steady_clock::time_point deadline) {
+        int threads = std::min<int>(threadCount, static_cast<int>(drivers.size() / (PARALLEL_DRIVER_THRESHOLD / 2)));
+        if (drivers.size() < PARALLEL_DRIVER_THRESHOLD) threads = 1;
+        threads = std::max(threads, 1);
+
+        std::vector<std::vector<Move>> found(threads);
+        std::vector<long long> evaluated(threads, 0);
+        auto evaluateRange = [&](int t, size_t begin, size_t end) {
+            Move move;
+            for (size_t d = begin; d < end; d++) {
+                if ((d - begin) % CLOCK_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline) break;
+                if (bestMoveFor(drivers[d], move, evaluated[t])) {
+                    found[t].push_back(move);
+                }
+            }
+        };
+
+        size_t chunk = (drivers.size() + threads - 1) / threads;
+        if (threads == 1) {
+            evaluateRange(0, 0, drivers.size());
+        } else {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; t++) {
+                size_t begin = std::min(t * chunk, drivers.size());
+                size_t end = std::min(begin + chunk, drivers.size());
+                workers.emplace_back(evaluateRange, t, begin, end);
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        }
+
+        std::vector<Move> proposals;
+        for (int t = 0; t < threads; t++) {
+            proposals.insert(proposals.end(), found[t].begin(), found[t].end());
+            evaluatedMoves += evaluated[t];
+        }
+        return proposals;
+    }
+
+    /**
+     * Apply proposals best first, skipping those an earlier move invalidated
+     * @param changedCenter Set for every center a move touched
+     * @return Number of moves applied
+     */
+    size_t applyMoves(std::vector<Move>& proposals, std::vector<char>& changedCenter) {
+        std::sort(proposals.begin(), proposals.end(), betterMove);
+
+        size_t applied = 0;
+        long long evaluated = 0;
+        for (Move& move : proposals) {
+            bool stale = assignedCenter[move.person] != move.from ||
+                (move.other != -1 && assignedCenter[move.other] != move.to) ||
+                (move.type == MoveType::Relocate && freeUnits[move.to] <= 0) ||
+                (move.type == MoveType::Ejection && freeUnits[move.otherTo] <= 0);
+            // A stale driver gets one fresh look at the current state; otherwise
+            // distances of untouched people are unchanged, so re-ranking is exact
+            if (stale ? !bestMoveFor(move.person, move, evaluated) : !rankMove(move)) continue;
+
+            if (move.other != -1) {
+                relocate(move.other, move.otherTo, move.otherDistance);
+                changedCenter[move.otherTo] = 1;
+            }
+            relocate(move.person, move.to, move.personDistance);
+            changedCenter[move.from] = 1;
+            changedCenter[move.to] = 1;
+
+            if (move.type == MoveType::Relocate) relocates++;
+            else if (move.type == MoveType::Swap) swaps++;
+            else ejections++;
+            applied++;
+        }
+        evaluatedMoves += evaluated;
+        return applied;
+    }
+
+    void relocate(int person, int to, double distance) {
+        int from = assignedCenter[person];
+        std::vector<int>& fromMembers = members[from];
+        int slot = memberSlot[person];
+        fromMembers[slot] = fromMembers.back();
+        memberSlot[fromMembers[slot]] = slot;
+        fromMembers.pop_back();
+        freeUnits[from]++;
+
+        memberSlot[person] = static_cast<int>(members[to].size());
+        members[to].push_back(person);
+        freeUnits[to]--;
+        assignedCenter[person] = to;
+        assignedDistance[person] = distance;
+    }
+};
+
+#endif // LOCAL_SEARCH_IMPROVER_H
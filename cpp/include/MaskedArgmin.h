@@ -0,0 +1,201 @@
+#ifndef MASKED_ARGMIN_H
+#define MASKED_ARGMIN_H
+
+#include <cstddef>
+#include <cfloat>
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MASKED_ARGMIN_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * Masked argmin over a float distance row: the index of the smallest
+ * row[j] + penalty[j], where penalty is 0 for an open center and +inf for a
+ * full one. Ties go to the lowest index and values >= FLT_MAX never win,
+ * exactly like the scalar loop.
+ *
+ * AVX2 and AVX-512 kernels are compiled with per-function target attributes
+ * and picked at runtime with __builtin_cpu_supports, so the binary still
+ * runs (on the scalar kernel) on CPUs without them.
+ */
+class MaskedArgmin {
+public:
+    enum class Kernel { Scalar, AVX2, AVX512 };
+
+    // Below this row length the AVX2 lane reduction costs more than it saves
+    static constexpr size_t AVX2_MIN_ROW = 256;
+
+    /**
+     * Find the masked minimum with the best kernel this CPU supports
+     * @param row Distances
+     * @param penalty 0 (open) or +inf (full) per entry
+     * @param n Entries
+     * @param bestValue Set to the minimum (FLT_MAX if none)
+     * @return Index of the minimum or -1 if every entry is masked
+     */
+    static int find(const float* row, const float* penalty, size_t n, float& bestValue) {
+        static const Kernel kernel = detect();
+        if (kernel == Kernel::AVX2 && n < AVX2_MIN_ROW) return findScalar(row, penalty, n, bestValue);
+        return findWith(kernel, row, penalty, n, bestValue);
+    }
+
+    /**
+     * Run a specific kernel (it must be supported)
+     */
+    static int findWith(Kernel kernel, const float* row, const float* penalty, size_t n, float& bestValue) {
+#ifdef MASKED_ARGMIN_X86
+        if (kernel == Kernel::AVX512) return findAvx512(row, penalty, n, bestValue);
+        if (kernel == Kernel::AVX2) return findAvx2(row, penalty, n, bestValue);
+#endif
+        return findScalar(row, penalty, n, bestValue);
+    }
+
+    /**
+     * Get the fastest kernel this CPU supports
+     */
+    static Kernel detect() {
+        if (isSupported(Kernel::AVX512)) return Kernel::AVX512;
+        if (isSupported(Kernel::AVX2)) return Kernel::AVX2;
+        return Kernel::Scalar;
+    }
+
+    static bool isSupported(Kernel kernel) {
+#ifdef MASKED_ARGMIN_X86
+        if (kernel == Kernel::AVX512) return __builtin_cpu_supports("avx512f");
+        if (kernel == Kernel::AVX2) return __builtin_cpu_supports("avx2");
+#endif
+        return kernel == Kernel::Scalar;
+    }
+
+    static std::string kernelName(Kernel kernel) {
+        return kernel == Kernel::AVX512 ? "avx512" : kernel == Kernel::AVX2 ? "avx2" : "scalar";
+    }
+
+    static int findScalar(const float* row, const float* penalty, size_t n, float& bestValue) {
+        int bestIndex = -1;
+        bestValue = FLT_MAX;
+        for (size_t j = 0; j < n; j++) {
+            float value = row[j] + penalty[j];
+            if (value < bestValue) {
+                bestValue = value;
+                bestIndex = static_cast<int>(j);
+            }
+        }
+        return bestIndex;
+    }
+
+private:
+    /**
+     * Pick the smallest lane value, lowest index on ties, then finish the
+     * tail serially (tail indices are higher, so strict < keeps ties first)
+     */
+    static int reduceLanes(const float* values, const int* indices, int lanes,
+                           const float* row, const float* penalty, size_t tail, size_t n, float& bestValue) {
+        int bestIndex = -1;
+        bestValue = FLT_MAX;
+        for (int lane = 0; lane < lanes; lane++) {
+            if (indices[lane] < 0) continue;
+            if (values[lane] < bestValue || (values[lane] == bestValue && indices[lane] < bestIndex)) {
+                bestValue = values[lane];
+                bestIndex = indices[lane];
+            }
+        }
+        for (size_t j = tail; j < n; j++) {
+            float value = row[j] + penalty[j];
+            if (value < bestValue) {
+                bestValue = value;
+                bestIndex = static_cast<int>(j);
+            }
+        }
+        return bestIndex;
+    }
+
+#ifdef MASKED_ARGMIN_X86
+    __attribute__((target("avx2")))
+    static int findAvx2(const float* row, const float* penalty, size_t n, float& bestValue) {
+        // Two independent accumulators hide the compare/blend latency
+        __m256 best0 = _mm256_set1_ps(FLT_MAX), best1 = best0;
+        __m256i index0 = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i index1 = _mm256_add_epi32(index0, _mm256_set1_epi32(8));
+        __m256i bestIndex0 = _mm256_set1_epi32(-1), bestIndex1 = bestIndex0;
+        const __m256i step = _mm256_set1_epi32(16);
+
+        size_t j = 0;
+        for (; j + 16 <= n; j += 16) {
+            __m256 value0 = _mm256_add_ps(_mm256_loadu_ps(row + j), _mm256_loadu_ps(penalty + j));
+            __m256 value1 = _mm256_add_ps(_mm256_loadu_ps(row + j + 8), _mm256_loadu_ps(penalty + j + 8));
+            __m256 less0 = _mm256_cmp_ps(value0, best0, _CMP_LT_OQ);
+            __m256 less1 = _mm256_cmp_ps(value1, best1, _CMP_LT_OQ);
+            best0 = _mm256_blendv_ps(best0, value0, less0);
+            best1 = _mm256_blendv_ps(best1, value1, less1);
+            bestIndex0 = _mm256_blendv_epi8(bestIndex0, index0, _mm256_castps_si256(less0));
+            bestIndex1 = _mm256_blendv_epi8(bestIndex1, index1, _mm256_castps_si256(less1));
+            index0 = _mm256_add_epi32(index0, step);
+            index1 = _mm256_add_epi32(index1, step);
+        }
+
+        // Fold the second accumulator into the first, keeping the lower index on ties
+        __m256 take = _mm256_or_ps(_mm256_cmp_ps(best1, best0, _CMP_LT_OQ),
+            _mm256_and_ps(_mm256_cmp_ps(best1, best0, _CMP_EQ_OQ),
+                          _mm256_castsi256_ps(_mm256_cmpgt_epi32(bestIndex0, bestIndex1))));
+        best0 = _mm256_blendv_ps(best0, best1, take);
+        bestIndex0 = _mm256_blendv_epi8(bestIndex0, bestIndex1, _mm256_castps_si256(take));
+
+        alignas(32) float values[8];
+        alignas(32) int indices[8];
+        _mm256_store_ps(values, best0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex0);
+        return reduceLanes(values, indices, 8, row, penalty, j, n, bestValue);
+    }
+
+    __attribute__((target("avx512f")))
+    static int findAvx512(const float* row, const float* penalty, size_t n, float& bestValue) {
+        __m512 best0 = _mm512_set1_ps(FLT_MAX), best1 = best0;
+        __m512i index0 = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m512i index1 = _mm512_add_epi32(index0, _mm512_set1_epi32(16));
+        __m512i bestIndex0 = _mm512_set1_epi32(-1), bestIndex1 = bestIndex0;
+        const __m512i step = _mm512_set1_epi32(32);
+
+        size_t j = 0;
+        for (; j + 32 <= n; j += 32) {
+            __m512 value0 = _mm512_add_ps(_mm512_loadu_ps(row + j), _mm512_loadu_ps(penalty + j));
+            __m512 value1 = _mm512_add_ps(_mm512_loadu_ps(row + j + 16), _mm512_loadu_ps(penalty + j + 16));
+            __mmask16 less0 = _mm512_cmp_ps_mask(value0, best0, _CMP_LT_OQ);
+            __mmask16 less1 = _mm512_cmp_ps_mask(value1, best1, _CMP_LT_OQ);
+            best0 = _mm512_mask_mov_ps(best0, less0, value0);
+            best1 = _mm512_mask_mov_ps(best1, less1, value1);
+            bestIndex0 = _mm512_mask_mov_epi32(bestIndex0, less0, index0);
+            bestIndex1 = _mm512_mask_mov_epi32(bestIndex1, less1, index1);
+            index0 = _mm512_add_epi32(index0, step);
+            index1 = _mm512_add_epi32(index1, step);
+        }
+
+        __mmask16 take = _mm512_cmp_ps_mask(best1, best0, _CMP_LT_OQ) |
+            (_mm512_cmp_ps_mask(best1, best0, _CMP_EQ_OQ) & _mm512_cmplt_epi32_mask(bestIndex1, bestIndex0));
+        best0 = _mm512_mask_mov_ps(best0, take, best1);
+        bestIndex0 = _mm512_mask_mov_epi32(bestIndex0, take, bestIndex1);
+
+        // Lowest index among the lanes holding the minimum
+        float minimum = _mm512_reduce_min_ps(best0);
+        int bestIndex = -1;
+        bestValue = FLT_MAX;
+        if (minimum < FLT_MAX) {
+            __mmask16 atMinimum = _mm512_cmp_ps_mask(best0, _mm512_set1_ps(minimum), _CMP_EQ_OQ);
+            bestIndex = _mm512_mask_reduce_min_epi32(atMinimum, bestIndex0);
+            bestValue = minimum;
+        }
+        for (; j < n; j++) {
+            float value = row[j] + penalty[j];
+            if (value < bestValue) {
+                bestValue = value;
+                bestIndex = static_cast<int>(j);
+            }
+        }
+        return bestIndex;
+    }
+#endif
+};
+
+#endif // MASKED_ARGMIN_H
@@ -0,0 +1,209 @@
+#ifndef MATRIX_CHECKPOINT_H
+#define MATRIX_CHECKPOINT_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <unistd.h>
+#include "DistanceMatrix.h"
+#include "RandomPointGenerator.h"
+
+/**
+ * Append-only checkpoint of completed person-row tiles of a distance matrix.
+ *
+ * File layout: a header identifying the inputs (hash of all coordinates,
+ * matrix dimensions and tile size) followed by one record per finished tile
+ * (tile index, row count, row-major float distances). Each record is flushed
+ * and fsync'ed, so a crash loses at most the tile being computed; a failed
+ * write or sync throws instead of reporting the tile as saved. A torn
+ * trailing record, or one whose row count does not fit its tile, is
+ * discarded on resume together with everything after it.
+ */
+class MatrixCheckpoint {
+private:
+    struct Header {
+        char magic[8];
+        uint64_t inputHash;
+        uint64_t personCount;
+        uint64_t centerCount;
+        uint64_t tileRows;
+    };
+
+    std::string path;
+    Header header;
+    FILE* file;
+
+public:
+    /**
+     * @param checkpointPath Checkpoint file
+     * @param people People the matrix is computed for
+     * @param testCenters Test centers the matrix is computed for
+     * @param tileRows Person rows per tile
+     */
+    MatrixCheckpoint(const std::string& checkpointPath, const std::vector<Point>& people,
+                     const std::vector<Point>& testCenters, size_t tileRows)
+        : path(checkpointPath), header(), file(nullptr) {
+        std::memcpy(header.magic, "RACKPT01", sizeof(header.magic));
+        header.inputHash = hashInputs(people, testCenters);
+        header.personCount = people.size();
+        header.centerCount = testCenters.size();
+        header.tileRows = tileRows;
+    }
+
+    ~MatrixCheckpoint() {
+        if (file) {
+            std::fclose(file);
+        }
+    }
+
+    MatrixCheckpoint(const MatrixCheckpoint&) = delete;
+    MatrixCheckpoint& operator=(const MatrixCheckpoint&) = delete;
+
+    /**
+     * Load tiles from an existing checkpoint with matching inputs, or start a
+     * new checkpoint if there is none or the inputs changed
+     * @param matrix Matrix receiving the restored rows
+     * @return Flags of tiles already completed
+     */
+    std::vector<bool> restore(DistanceMatrix& matrix) {
+        size_t tileCount = (header.personCount + header.tileRows - 1) / header.tileRows;
+        std::vector<bool> completed(tileCount, false);
+
+        file = std::fopen(path.c_str(), "r+b");
+        Header existing;
+        if (file && std::fread(&existing, sizeof(existing), 1, file) == 1 &&
+            std::memcmp(&existing, &header, sizeof(header)) == 0) {
+            long validEnd = readTiles(matrix, completed);
+            // Drop a torn trailing record before appending
+            if (ftruncate(fileno(file), validEnd) != 0 || std::fseek(file, validEnd, SEEK_SET) != 0) {
+                throw std::runtime_error("Cannot rewind checkpoint file: " + path);
+            }
+
+            size_t restored = std::count(completed.begin(), completed.end(), true);
+            std::cout << "Resuming from checkpoint: " << restored << "/" << tileCount << " tiles done" << std::endl;
+            return completed;
+        }
+
+        if (file) {
+            std::cout << "Checkpoint inputs changed, starting over" << std::endl;
+            std::fclose(file);
+        }
+
+        file = std::fopen(path.c_str(), "w+b");
+        if (!file) {
+            throw std::runtime_error("Cannot create checkpoint file: " + path);
+        }
+        writeChecked(&header, sizeof(header), 1);
+        sync();
+        return completed;
+    }
+
+    /**
+     * Durably record a finished tile
+     * @param tileIndex Tile index
+     * @param matrix Matrix holding the tile's rows
+     */
+    void saveTile(size_t tileIndex, const DistanceMatrix& matrix) {
+        uint64_t rowBegin = tileIndex * header.tileRows;
+        uint64_t rowCount = std::min<uint64_t>(header.tileRows, header.personCount - rowBegin);
+        uint64_t index = tileIndex;
+
+        std::vector<float> values(rowCount * header.centerCount);
+        for (uint64_t i = 0; i < rowCount; i++) {
+            for (uint64_t j = 0; j < header.centerCount; j++) {
+                values[i * header.centerCount + j] = static_cast<float>(matrix.get(rowBegin + i, j));
+            }
+        }
+
+        writeChecked(&index, sizeof(index), 1);
+        writeChecked(&rowCount, sizeof(rowCount), 1);
+        writeChecked(values.data(), sizeof(float), values.size());
+        sync();
+    }
+
+    /**
+     * Remove the checkpoint after the matrix is complete
+     */
+    void complete() {
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+        std::remove(path.c_str());
+    }
+
+    /**
+     * FNV-1a hash over the coordinates of all people and centers
+     * @param people People
+     * @param testCenters Test centers
+     * @return 64-bit hash
+     */
+    static uint64_t hashInputs(const std::vector<Point>& people, const std::vector<Point>& testCenters) {
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ULL;
+            }
+        };
+
+        for (const auto* points : {&people, &testCenters}) {
+            uint64_t count = points->size();
+            mix(&count, sizeof(count));
+            for (const Point& point : *points) {
+                mix(&point.latitude, sizeof(point.latitude));
+                mix(&point.longitude, sizeof(point.longitude));
+            }
+        }
+        return hash;
+    }
+
+private:
+    long readTiles(DistanceMatrix& matrix, std::vector<bool>& completed) {
+        long validEnd = std::ftell(file);
+        uint64_t index, rowCount;
+        std::vector<float> values;
+
+        while (std::fread(&index, sizeof(index), 1, file) == 1 &&
+               std::fread(&rowCount, sizeof(rowCount), 1, file) == 1) {
+            if (index >= completed.size()) break;
+            uint64_t expectedRows = std::min<uint64_t>(header.tileRows, header.personCount - index * header.tileRows);
+            if (rowCount != expectedRows) break;
+
+            values.resize(rowCount * header.centerCount);
+            if (std::fread(values.data(), sizeof(float), values.size(), file) != values.size()) break;
+
+            uint64_t rowBegin = index * header.tileRows;
+            for (uint64_t i = 0; i < rowCount; i++) {
+                for (uint64_t j = 0; j < header.centerCount; j++) {
+                    matrix.setWidening(rowBegin + i, j, values[i * header.centerCount + j]);
+                }
+            }
+            completed[index] = true;
+            validEnd = std::ftell(file);
+        }
+
+        return validEnd;
+    }
+
+    void writeChecked(const void* data, size_t size, size_t count) {
+        if (std::fwrite(data, size, count, file) != count) {
+            throw std::runtime_error("Cannot write checkpoint file " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    void sync() {
+        if (std::fflush(file) != 0 || fsync(fileno(file)) != 0) {
+            throw std::runtime_error("Cannot sync checkpoint file " + path + ": " + std::strerror(errno));
+        }
+    }
+};
+
+#endif // MATRIX_CHECKPOINT_H
@@ -0,0 +1,53 @@
+#ifndef MATRIX_ROW_CANDIDATES_H
+#define MATRIX_ROW_CANDIDATES_H
+
+#include <vector>
+#include <cmath>
+#include "DistanceMatrix.h"
+#include "CandidateDistanceMatrix.h"
+
+/**
+ * Candidate lists read straight from the rows of a dense matrix, for the
+ * optimal engines on the dense path.
+ *
+ * Every reachable center of a row is a candidate, so the solvers see the
+ * same arcs as with a full copy of the matrix, but only one row is held at
+ * a time: a returned list stays valid until the next call. The matrix is
+ * only read, so it can be shared between runs.
+ */
+class MatrixRowCandidates {
+private:
+    const DistanceMatrix& matrix;
+    std::vector<DistanceCandidate> rowScratch;
+
+public:
+    /**
+     * @param distances Dense matrix (must outlive the lists)
+     */
+    explicit MatrixRowCandidates(const DistanceMatrix& distances)
+        : matrix(distances) {
+        rowScratch.reserve(distances.getCenterCount());
+    }
+
+    /**
+     * Get candidate list of a person
+     * @param personIndex Person index
+     * @return Reachable centers in center order, valid until the next call
+     */
+    const std::vector<DistanceCandidate>& getCandidates(int personIndex) {
+        rowScratch.clear();
+        size_t centers = matrix.getCenterCount();
+        bool floatRow = matrix.getPrecision() == MatrixPrecision::Float32 &&
+                        matrix.getLayout() == MatrixLayout::PersonMajor;
+        const float* row = floatRow ? matrix.floatRow(personIndex) : nullptr;
+        for (size_t j = 0; j < centers; j++) {
+            double distance = floatRow ? row[j] : matrix.get(personIndex, j);
+            if (std::isfinite(distance)) {
+                rowScratch.emplace_back(static_cast<int>(j), distance);
+            }
+        }
+        return rowScratch;
+    }
+};
+
+#endif // MATRIX_ROW_CANDIDATES_H
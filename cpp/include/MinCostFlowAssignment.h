@@ -0,0 +1,299 @@
+#ifndef MIN_COST_FLOW_ASSIGNMENT_H
+#define MIN_COST_FLOW_ASSIGNMENT_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include "TieredAssignmentBase.h"
+
+/**
+ * Optimal capacitated assignment over candidate (person, center) arcs by
+ * cost-scaling push-relabel min-cost flow.
+ *
+ * Per tier the network is people -> candidate centers -> sink, with
+ * center -> sink capacity equal to the remaining center capacity, plus an
+ * "unassigned" arc from every person straight to the sink. That arc costs
+ * more than any simple path through real centers, so coverage is maximized
+ * before distance. Costs are integer meters scaled by the node count, so the
+ * final 1-optimal flow is exactly optimal.
+ *
+ * Priority is lexicographic: tiers are solved in order and each finished
+ * tier is frozen, so a lower tier can never take a center from, or lengthen
+ * the trip of, a higher tier. Within a tier the result covers as many people
+ * as possible, and among those covers it minimizes total distance.
+ *
+ * If people of a tier end up unassigned while capacity is still free, their
+ * candidate lists are extended and the tier is solved again.
+ */
+class MinCostFlowAssignment : public TieredAssignmentBase {
+private:
+    static constexpr int64_t SCALING_FACTOR = 4; // Epsilon divisor per refine
+
+    // Residual network of the tier being solved, in CSR form
+    // Nodes: tier people [0, m), centers [m, m + C), sink m + C
+    int tierPersonNodes;
+    std::vector<int> firstArc;
+    std::vector<int> arcHead;
+    std::vector<int> arcReverse;
+    std::vector<int> arcResidual;
+    std::vector<int64_t> arcCost;
+    std::vector<int64_t> price;
+    std::vector<int64_t> excess;
+    std::vector<int> currentArc;
+
+    long long refines;
+    long long pushes;
+    long long relabels;
+
+public:
+    /**
+     * @param people Number of people
+     * @param capacities Remaining capacity of each center
+     * @param candidates Candidate centers of a person (distances in km)
+     * @param extender Adds more candidates for a person, false once exhausted (optional)
+     */
+    MinCostFlowAssignment(size_t people, const std::vector<int>& capacities,
+                          CandidateList candidates, CandidateExtender extender = nullptr)
+        : TieredAssignmentBase(people, capacities, candidates, extender)
+        , tierPersonNodes(0)
+        , refines(0)
+        , pushes(0)
+        , relabels(0) {}
+
+    /**
+     * Optimally assign one priority tier on top of the frozen earlier tiers
+     * @param tierPeople Person indices of the tier
+     * @return Number of people of the tier assigned
+     */
+    int assignTier(const std::vector<int>& tierPeople) {
+        if (tierPeople.empty()) return 0;
+
+        int round = 0;
+        while (true) {
+            solveTier(tierPeople);
+
+            long long freeUnits = 0;
+            for (size_t j = 0; j < remainingCapacity.size(); j++) {
+                freeUnits += remainingCapacity[j] - tierLoad(j);
+            }
+
+            if (freeUnits <= 0 || !extendUnassigned(tierPeople, [&](size_t i) {
+                    return assignedCenter[tierPeople[i]] == -1;
+                }, round)) {
+                break;
+            }
+        }
+
+        return freezeTier(tierPeople);
+    }
+
+    /**
+     * Get solver statistics
+     * @return Refine, push, relabel and extension counters
+     */
+    std::map<std::string, long long> getSolverStats() const {
+        std::map<std::string, long long> stats;
+        stats["refines"] = refines;
+        stats["pushes"] = pushes;
+        stats["relabels"] = relabels;
+        stats["extension_rounds"] = extensionRounds;
+        return stats;
+    }
+
+private:
+    /**
+     * Units the solved tier routes through a center; each center's first arc
+     * is its sink arc, whose reverse residual equals the flow
+     */
+    int tierLoad(size_t centerIndex) const {
+        int arc = firstArc[tierPersonNodes + centerIndex];
+        return arcResidual[arcReverse[arc]];
+    }
+
+    /**
+     * Build the tier network, run cost scaling and read back assignments
+     */
+    void solveTier(const std::vector<int>& tierPeople) {
+        int personNodes = static_cast<int>(tierPeople.size());
+        tierPersonNodes = personNodes;
+        int centerNodes = static_cast<int>(remainingCapacity.size());
+        int sink = personNodes + centerNodes;
+        int nodeCount = sink + 1;
+
+        // Unassigned cost must exceed any simple path through centers
+        int64_t maxCost = 1;
+        std::vector<int> degree(nodeCount, 0);
+        for (int i = 0; i < personNodes; i++) {
+            for (const DistanceCandidate& candidate : candidatesOf(tierPeople[i])) {
+                if (!isReachable(candidate)) continue;
+                maxCost = std::max(maxCost, toMeters(candidate.distance));
+                degree[i]++;
+                degree[personNodes + candidate.centerIndex]++;
+            }
+            degree[i]++;
+            degree[sink]++;
+        }
+        for (int j = 0; j < centerNodes; j++) {
+            degree[personNodes + j]++;
+            degree[sink]++;
+        }
+        int64_t unassignedCost = (static_cast<int64_t>(centerNodes) + 2) * maxCost;
+
+        firstArc.assign(nodeCount + 1, 0);
+        for (int v = 0; v < nodeCount; v++) {
+            firstArc[v + 1] = firstArc[v] + degree[v];
+        }
+        size_t arcCount = firstArc[nodeCount];
+        arcHead.assign(arcCount, 0);
+        arcReverse.assign(arcCount, 0);
+        arcResidual.assign(arcCount, 0);
+        arcCost.assign(arcCount, 0);
+
+        std::vector<int> nextArc(firstArc.begin(), firstArc.end() - 1);
+        auto addArc = [&](int from, int to, int capacity, int64_t cost) {
+            int forward = nextArc[from]++;
+            int backward = nextArc[to]++;
+            arcHead[forward] = to;
+            arcResidual[forward] = capacity;
+            arcCost[forward] = cost * nodeCount;
+            arcReverse[forward] = backward;
+            arcHead[backward] = from;
+            arcResidual[backward] = 0;
+            arcCost[backward] = -cost * nodeCount;
+            arcReverse[backward] = forward;
+        };
+
+        // Center -> sink arcs first so each center's first arc is its sink arc
+        for (int j = 0; j < centerNodes; j++) {
+            addArc(personNodes + j, sink, remainingCapacity[j], 0);
+        }
+        for (int i = 0; i < personNodes; i++) {
+            for (const DistanceCandidate& candidate : candidatesOf(tierPeople[i])) {
+                if (!isReachable(candidate)) continue;
+                addArc(i, personNodes + candidate.centerIndex, 1, toMeters(candidate.distance));
+            }
+            addArc(i, sink, 1, unassignedCost);
+        }
+
+        price.assign(nodeCount, 0);
+        excess.assign(nodeCount, 0);
+        for (int i = 0; i < personNodes; i++) {
+            excess[i] = 1;
+        }
+        excess[sink] = -personNodes;
+
+        int64_t epsilon = unassignedCost * nodeCount;
+        do {
+            epsilon = std::max<int64_t>(epsilon / SCALING_FACTOR, 1);
+            refine(epsilon);
+            refines++;
+        } while (epsilon > 1);
+
+        for (int i = 0; i < personNodes; i++) {
+            int personIndex = tierPeople[i];
+            assignedCenter[personIndex] = -1;
+            assignedDistance[personIndex] = 0.0;
+
+            const std::vector<DistanceCandidate>& candidates = candidatesOf(personIndex);
+            size_t c = 0;
+            for (int arc = firstArc[i]; arc < firstArc[i + 1]; arc++) {
+                if (arcHead[arc] == sink) continue;
+                // Person arcs were added in order of the reachable candidates
+                while (!isReachable(candidates[c])) c++;
+                if (arcResidual[arc] == 0) {
+                    assignedCenter[personIndex] = candidates[c].centerIndex;
+                    assignedDistance[personIndex] = candidates[c].distance;
+                }
+                c++;
+            }
+        }
+    }
+
+    int64_t reducedCost(int from, int arc) const {
+        return arcCost[arc] + price[from] - price[arcHead[arc]];
+    }
+
+    /**
+     * Turn an epsilon*alpha-optimal flow into an epsilon-optimal one
+     */
+    void refine(int64_t epsilon) {
+        int nodeCount = static_cast<int>(price.size());
+        std::deque<int> active;
+        std::vector<char> queued(nodeCount, 0);
+
+        // Saturate every arc with negative reduced cost
+        for (int v = 0; v < nodeCount; v++) {
+            for (int arc = firstArc[v]; arc < firstArc[v + 1]; arc++) {
+                if (arcResidual[arc] > 0 && reducedCost(v, arc) < 0) {
+                    int amount = arcResidual[arc];
+                    arcResidual[arc] = 0;
+                    arcResidual[arcReverse[arc]] += amount;
+                    excess[v] -= amount;
+                    excess[arcHead[arc]] += amount;
+                }
+            }
+        }
+
+        for (int v = 0; v < nodeCount; v++) {
+            if (excess[v] > 0) {
+                active.push_back(v);
+                queued[v] = 1;
+            }
+        }
+        currentArc.assign(firstArc.begin(), firstArc.end() - 1);
+
+        while (!active.empty()) {
+            int v = active.front();
+            active.pop_front();
+            queued[v] = 0;
+            discharge(v, epsilon, active, queued);
+        }
+    }
+
+    void discharge(int v, int64_t epsilon, std::deque<int>& active, std::vector<char>& queued) {
+        while (excess[v] > 0) {
+            int arc = currentArc[v];
+            if (arc == firstArc[v + 1]) {
+                relabel(v, epsilon);
+                continue;
+            }
+
+            if (arcResidual[arc] > 0 && reducedCost(v, arc) < 0) {
+                int to = arcHead[arc];
+                int amount = static_cast<int>(std::min<int64_t>(excess[v], arcResidual[arc]));
+                arcResidual[arc] -= amount;
+                arcResidual[arcReverse[arc]] += amount;
+                excess[v] -= amount;
+                excess[to] += amount;
+                pushes++;
+
+                if (excess[to] > 0 && !queued[to]) {
+                    active.push_back(to);
+                    queued[to] = 1;
+                }
+            } else {
+                currentArc[v]++;
+            }
+        }
+    }
+
+    void relabel(int v, int64_t epsilon) {
+        int64_t best = std::numeric_limits<int64_t>::min();
+        for (int arc = firstArc[v]; arc < firstArc[v + 1]; arc++) {
+            if (arcResidual[arc] > 0) {
+                best = std::max(best, price[arcHead[arc]] - arcCost[arc]);
+            }
+        }
+        price[v] = best - epsilon;
+        currentArc[v] = firstArc[v];
+        relabels++;
+    }
+};
+
+#endif // MIN_COST_FLOW_ASSIGNMENT_H
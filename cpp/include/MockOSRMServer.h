@@ -0,0 +1,476 @@
+#ifndef MOCK_OSRM_SERVER_H
+#define MOCK_OSRM_SERVER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "DistanceBackend.h"
+
+struct MockServerConfig {
+    int port;
+    double latencyMs;        // Added to every request
+    double latencyJitterMs;  // Uniform extra latency in [0, jitter)
+    double errorRate;        // Fraction of requests answered with HTTP 500
+    int maxConcurrency;      // Requests beyond this are answered with HTTP 429
+    double speedKmh;         // Used to derive durations from distances
+
+    MockServerConfig()
+        : port(5000), latencyMs(0.0), latencyJitterMs(0.0), errorRate(0.0), maxConcurrency(64), speedKmh(40.0) {}
+};
+
+struct MockServerStats {
+    long long requests;
+    long long routeRequests;
+    long long tableRequests;
+    long long injectedErrors;
+    long long rejected;
+    long long badRequests;
+    long long acceptErrors;
+};
+
+/**
+ * Minimal HTTP/1.1 server speaking the OSRM /route and /table response format,
+ * backed by any DistanceBackend (Haversine or the local graph engine).
+ *
+ * Each connection is served by its own thread and closed after one response.
+ * The backend is called concurrently and must be safe for concurrent reads.
+ *
+ * The accept thread polls the listening socket together with a wake-up
+ * pipe; stop() writes to the pipe and closes the socket only after the
+ * thread has exited. Accept failures from exhausted resources (file
+ * descriptors, buffers) back off before retrying; any other failure ends
+ * the accept loop.
+ */
+class MockOSRMServer {
+private:
+    std::shared_ptr<DistanceBackend> backend;
+    MockServerConfig config;
+    static constexpr int MAX_ACCEPT_BACKOFF_MS = 1000;
+
+    int listenSocket;
+    int wakePipe[2]; // Written by stop() to end the accept loop
+    std::thread acceptThread;
+    std::atomic<bool> running;
+    std::atomic<int> activeRequests;
+    std::atomic<int> openConnections;
+    std::mutex connectionsMutex;
+    std::condition_variable connectionsDone;
+
+    std::atomic<long long> requestCount;
+    std::atomic<long long> routeCount;
+    std::atomic<long long> tableCount;
+    std::atomic<long long> errorCount;
+    std::atomic<long long> rejectedCount;
+    std::atomic<long long> badRequestCount;
+    std::atomic<long long> acceptErrorCount;
+
+public:
+    MockOSRMServer(std::shared_ptr<DistanceBackend> distanceBackend, const MockServerConfig& serverConfig = MockServerConfig())
+        : backend(distanceBackend), config(serverConfig), listenSocket(-1), wakePipe{-1, -1}, running(false)
+        , activeRequests(0), openConnections(0), requestCount(0), routeCount(0), tableCount(0)
+        , errorCount(0), rejectedCount(0), badRequestCount(0), acceptErrorCount(0) {}
+
+    ~MockOSRMServer() {
+        stop();
+    }
+
+    MockOSRMServer(const MockOSRMServer&) = delete;
+    MockOSRMServer& operator=(const MockOSRMServer&) = delete;
+
+    /**
+     * Bind the port and start accepting connections in the background
+     */
+    void start() {
+        listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenSocket < 0) {
+            throw std::runtime_error("Cannot create server socket");
+        }
+
+        int reuse = 1;
+        ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        // Non-blocking so a connection reset between poll and accept cannot stall the loop
+        ::fcntl(listenSocket, F_SETFL, ::fcntl(listenSocket, F_GETFL) | O_NONBLOCK);
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(config.port);
+
+        if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listenSocket, 128) != 0) {
+            ::close(listenSocket);
+            listenSocket = -1;
+            throw std::runtime_error("Cannot listen on port " + std::to_string(config.port));
+        }
+
+        // Report the actual port when 0 (ephemeral) was requested
+        socklen_t length = sizeof(address);
+        ::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+        config.port = ntohs(address.sin_port);
+
+        if (::pipe(wakePipe) != 0) {
+            ::close(listenSocket);
+            listenSocket = -1;
+            throw std::runtime_error("Cannot create server wake-up pipe");
+        }
+
+        running = true;
+        acceptThread = std::thread(&MockOSRMServer::acceptLoop, this);
+    }
+
+    /**
+     * Stop accepting connections and wait for in-flight requests
+     */
+    void stop() {
+        if (!running.exchange(false)) return;
+
+        // Wake the accept thread; the socket is closed only once it has exited
+        char wake = 1;
+        while (::write(wakePipe[1], &wake, 1) < 0 && errno == EINTR) {}
+        if (acceptThread.joinable()) {
+            acceptThread.join();
+        }
+        ::close(listenSocket);
+        ::close(wakePipe[0]);
+        ::close(wakePipe[1]);
+        listenSocket = -1;
+        wakePipe[0] = wakePipe[1] = -1;
+
+        std::unique_lock<std::mutex> lock(connectionsMutex);
+        connectionsDone.wait(lock, [this] { return openConnections == 0; });
+    }
+
+    /**
+     * Get bound port
+     * @return Port number
+     */
+    int getPort() const {
+        return config.port;
+    }
+
+    /**
+     * Base URL for OSRMBackend, e.g. http://127.0.0.1:5000/route/v1/driving
+     * @return Route service URL
+     */
+    std::string getRouteUrl() const {
+        return "http://127.0.0.1:" + std::to_string(config.port) + "/route/v1/driving";
+    }
+
+    /**
+     * Get request counters
+     * @return Server statistics
+     */
+    MockServerStats getStats() const {
+        return {requestCount, routeCount, tableCount, errorCount, rejectedCount, badRequestCount, acceptErrorCount};
+    }
+
+    /**
+     * Build the response body for a request target (exposed for reuse by tests and tools)
+     * @param target Request target, e.g. /route/v1/driving/lon,lat;lon,lat
+     * @param status Receives the HTTP status code
+     * @return JSON body
+     */
+    std::string handleTarget(const std::string& target, int& status) {
+        std::string path = target.substr(0, target.find('?'));
+        std::string query = target.find('?') == std::string::npos ? "" : target.substr(target.find('?') + 1);
+
+        // /{service}/v1/{profile}/{coordinates}
+        std::vector<std::string> segments = split(path, '/');
+        if (segments.size() != 5 || segments[2] != "v1") {
+            status = 400;
+            badRequestCount++;
+            return errorBody("InvalidUrl", "Expected /{service}/v1/{profile}/{coordinates}");
+        }
+
+        std::vector<Point> points;
+        if (!parseCoordinates(segments[4], points)) {
+            status = 400;
+            badRequestCount++;
+            return errorBody("InvalidQuery", "Invalid coordinates");
+        }
+
+        try {
+            if (segments[1] == "route") {
+                routeCount++;
+                return routeBody(points, status);
+            }
+            if (segments[1] == "table") {
+                tableCount++;
+                return tableBody(points, query, status);
+            }
+        } catch (const std::exception& e) {
+            status = 500;
+            return errorBody("InternalError", e.what());
+        }
+
+        status = 400;
+        badRequestCount++;
+        return errorBody("InvalidService", "Service " + segments[1] + " not found");
+    }
+
+private:
+    void acceptLoop() {
+        int backoffMs = 0;
+        pollfd watched[2] = {{listenSocket, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+        while (running) {
+            if (::poll(watched, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Mock OSRM server: poll failed: " << std::strerror(errno) << std::endl;
+                return;
+            }
+            if (watched[1].revents != 0) return; // stop() was called
+
+            int client = ::accept(listenSocket, nullptr, nullptr);
+            if (client < 0) {
+                int error = errno;
+                if (error == EINTR || error == EAGAIN || error == EWOULDBLOCK || error == ECONNABORTED) continue;
+                acceptErrorCount++;
+                if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+                    // Out of resources: wait for connections to close instead of spinning
+                    backoffMs = std::min(std::max(backoffMs * 2, 10), MAX_ACCEPT_BACKOFF_MS);
+                    ::poll(&watched[1], 1, backoffMs);
+                    continue;
+                }
+                std::cerr << "Mock OSRM server: accept failed: " << std::strerror(error) << std::endl;
+                return;
+            }
+            backoffMs = 0;
+
+            openConnections++;
+            std::thread(&MockOSRMServer::serveConnection, this, client).detach();
+        }
+    }
+
+    void serveConnection(int client) {
+        std::string request;
+        char buffer[4096];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 65536) {
+            ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+            if (received <= 0) break;
+            request.append(buffer, received);
+        }
+
+        requestCount++;
+        int status = 200;
+        std::string body;
+
+        if (activeRequests.fetch_add(1) >= config.maxConcurrency) {
+            status = 429;
+            rejectedCount++;
+            body = errorBody("TooBig", "Too many concurrent requests");
+        } else {
+            injectLatency();
+
+            std::istringstream requestLine(request.substr(0, request.find("\r\n")));
+            std::string method, target;
+            requestLine >> method >> target;
+
+            if (method != "GET") {
+                status = 400;
+                badRequestCount++;
+                body = errorBody("InvalidQuery", "Only GET is supported");
+            } else if (shouldFail()) {
+                status = 500;
+                errorCount++;
+                body = errorBody("InternalError", "Injected error");
+            } else {
+                body = handleTarget(target, status);
+            }
+        }
+        activeRequests--;
+
+        std::ostringstream response;
+        response << "HTTP/1.1 " << status << " " << statusText(status) << "\r\n"
+                 << "Content-Type: application/json\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << body;
+        std::string data = response.str();
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t written = ::send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) break;
+            sent += written;
+        }
+        ::close(client);
+
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        if (--openConnections == 0) {
+            connectionsDone.notify_all();
+        }
+    }
+
+    std::string routeBody(const std::vector<Point>& points, int& status) {
+        if (points.size() < 2) {
+            status = 400;
+            badRequestCount++;
+            return errorBody("InvalidQuery", "Route needs at least two coordinates");
+        }
+
+        double totalKm = 0.0;
+        std::ostringstream legs;
+        for (size_t i = 1; i < points.size(); i++) {
+            double legKm = backend->calculateDistance(points[i - 1], points[i]);
+            totalKm += legKm;
+            legs << (i > 1 ? "," : "") << "{\"distance\":" << legKm * 1000.0
+                 << ",\"duration\":" << durationSeconds(legKm) << ",\"steps\":[]}";
+        }
+
+        std::ostringstream body;
+        body << std::fixed << std::setprecision(1)
+             << "{\"code\":\"Ok\",\"routes\":[{\"distance\":" << totalKm * 1000.0
+             << ",\"duration\":" << durationSeconds(totalKm)
+             << ",\"weight\":" << durationSeconds(totalKm)
+             << ",\"legs\":[" << legs.str() << "]}],\"waypoints\":" << waypoints(points) << "}";
+        return body.str();
+    }
+
+    std::string tableBody(const std::vector<Point>& points, const std::string& query, int& status) {
+        std::vector<int> sources = parseIndexList(queryParameter(query, "sources"), points.size());
+        std::vector<int> destinations = parseIndexList(queryParameter(query, "destinations"), points.size());
+        if (sources.empty() || destinations.empty()) {
+            status = 400;
+            badRequestCount++;
+            return errorBody("InvalidQuery", "Invalid sources or destinations");
+        }
+
+        std::ostringstream distances, durations;
+        distances << std::fixed << std::setprecision(1);
+        durations << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < sources.size(); i++) {
+            distances << (i > 0 ? "," : "") << "[";
+            durations << (i > 0 ? "," : "") << "[";
+            for (size_t j = 0; j < destinations.size(); j++) {
+                double km = backend->calculateDistance(points[sources[i]], points[destinations[j]]);
+                distances << (j > 0 ? "," : "") << km * 1000.0;
+                durations << (j > 0 ? "," : "") << durationSeconds(km);
+            }
+            distances << "]";
+            durations << "]";
+        }
+
+        std::vector<Point> sourcePoints, destinationPoints;
+        for (int index : sources) sourcePoints.push_back(points[index]);
+        for (int index : destinations) destinationPoints.push_back(points[index]);
+
+        return "{\"code\":\"Ok\",\"durations\":[" + durations.str() + "],\"distances\":[" +
+               distances.str() + "],\"sources\":" + waypoints(sourcePoints) +
+               ",\"destinations\":" + waypoints(destinationPoints) + "}";
+    }
+
+    double durationSeconds(double km) const {
+        return km / config.speedKmh * 3600.0;
+    }
+
+    std::string waypoints(const std::vector<Point>& points) const {
+        std::ostringstream out;
+        out << std::setprecision(9) << "[";
+        for (size_t i = 0; i < points.size(); i++) {
+            out << (i > 0 ? "," : "") << "{\"location\":[" << points[i].longitude << "," << points[i].latitude << "]}";
+        }
+        out << "]";
+        return out.str();
+    }
+
+    static std::string errorBody(const std::string& code, const std::string& message) {
+        return "{\"code\":\"" + code + "\",\"message\":\"" + message + "\"}";
+    }
+
+    static const char* statusText(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 429: return "Too Many Requests";
+            default: return "Internal Server Error";
+        }
+    }
+
+    static std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::string part;
+        std::istringstream stream(text);
+        while (std::getline(stream, part, separator)) {
+            parts.push_back(part);
+        }
+        return parts;
+    }
+
+    // OSRM coordinates are "lon,lat;lon,lat;..."
+    static bool parseCoordinates(const std::string& text, std::vector<Point>& points) {
+        for (const std::string& pair : split(text, ';')) {
+            std::vector<std::string> values = split(pair, ',');
+            if (values.size() != 2) return false;
+            try {
+                points.emplace_back(std::stod(values[1]), std::stod(values[0]));
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        return !points.empty();
+    }
+
+    static std::string queryParameter(const std::string& query, const std::string& name) {
+        for (const std::string& parameter : split(query, '&')) {
+            if (parameter.compare(0, name.size() + 1, name + "=") == 0) {
+                return parameter.substr(name.size() + 1);
+            }
+        }
+        return "all";
+    }
+
+    static std::vector<int> parseIndexList(const std::string& text, size_t count) {
+        std::vector<int> indices;
+        if (text == "all") {
+            for (size_t i = 0; i < count; i++) indices.push_back(i);
+            return indices;
+        }
+        for (const std::string& value : split(text, ';')) {
+            try {
+                int index = std::stoi(value);
+                if (index < 0 || index >= static_cast<int>(count)) return {};
+                indices.push_back(index);
+            } catch (const std::exception&) {
+                return {};
+            }
+        }
+        return indices;
+    }
+
+    void injectLatency() {
+        double delayMs = config.latencyMs;
+        if (config.latencyJitterMs > 0) {
+            thread_local std::mt19937 generator(std::random_device{}());
+            delayMs += std::uniform_real_distribution<double>(0.0, config.latencyJitterMs)(generator);
+        }
+        if (delayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(delayMs));
+        }
+    }
+
+    bool shouldFail() {
+        if (config.errorRate <= 0) return false;
+        thread_local std::mt19937 generator(std::random_device{}());
+        return std::uniform_real_distribution<double>(0.0, 1.0)(generator) < config.errorRate;
+    }
+};
+
+#endif // MOCK_OSRM_SERVER_H
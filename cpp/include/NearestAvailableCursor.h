@@ -0,0 +1,245 @@
+#ifndef NEAREST_AVAILABLE_CURSOR_H
+#define NEAREST_AVAILABLE_CURSOR_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "DistanceMatrix.h"
+#include "CandidateDistanceMatrix.h"
+#include "CenterSpatialIndex.h"
+
+/**
+ * Nearest-available-center selection over a dense distance matrix.
+ *
+ * Each person gets, on first query, a sorted list of up to k open centers
+ * plus a cursor into that list. Centers only ever go from open to full while
+ * assigning, so a full center skipped by the cursor never has to be looked
+ * at again. A listed center is the answer once nothing outside the list can
+ * be nearer: every unlisted open center is at least the list's bound away.
+ *
+ * Lists come from one of two sources:
+ * - a scan of the matrix row (bound = infinity, since the scan kept the k
+ *   smallest entries), which costs O(C log k) per list;
+ * - with useStraightLineBound(), the k nearest open centers from a spatial
+ *   index, which costs O(k log k) plus the grid cells visited. The bound is
+ *   the straight-line distance to the k-th of them, less storage rounding.
+ *   If the open center at the cursor is not below the bound, that row is
+ *   scanned instead.
+ *
+ * A row scan reads all C centers just like the plain masked scan, so only
+ * indexed lists (or repeated queries) make a pass cheaper than O(P·C).
+ * Unreachable (non-finite) entries are never listed, matching the full scan.
+ * Call reset() if capacity is ever added back.
+ */
+class NearestAvailableCursor {
+private:
+    static constexpr double FLOAT_ROUNDING = 1e-6; // Relative rounding of Float32 entries, with headroom
+
+    const DistanceMatrix& matrix;
+    size_t listSize;
+    std::vector<std::vector<DistanceCandidate>> lists; // Ascending by distance
+    std::vector<unsigned int> cursor;
+    std::vector<float> bound; // Unlisted open centers are at least this far
+
+    // Straight-line seeding (null = scan rows)
+    const std::vector<Point>* people;
+    const std::vector<Point>* centers;
+    std::unique_ptr<CenterSpatialIndex> centerIndex;
+    double roundingKm;
+
+    long long listsBuilt;
+    long long indexedLists;
+    long long rowScans;
+    long long rescans;
+    long long skippedFull;
+
+public:
+    /**
+     * @param distances Dense matrix (must outlive the cursor)
+     * @param k Centers per sorted list
+     */
+    NearestAvailableCursor(const DistanceMatrix& distances, size_t k = 8)
+        : matrix(distances)
+        , listSize(std::max<size_t>(k, 1))
+        , lists(distances.getPersonCount())
+        , cursor(distances.getPersonCount(), 0)
+        , bound(distances.getPersonCount(), std::numeric_limits<float>::infinity())
+        , people(nullptr)
+        , centers(nullptr)
+        , roundingKm(0.0)
+        , listsBuilt(0)
+        , indexedLists(0)
+        , rowScans(0)
+        , rescans(0)
+        , skippedFull(0) {}
+
+    /**
+     * Declare the matrix entries straight-line distances between these
+     * points (up to storage rounding), so lists are seeded from a spatial
+     * index over the centers instead of a row scan
+     * @param peopleRows People in matrix row order (must outlive the cursor)
+     * @param testCenters Centers in matrix column order (must outlive the cursor)
+     */
+    void useStraightLineBound(const std::vector<Point>& peopleRows, const std::vector<Point>& testCenters) {
+        people = &peopleRows;
+        centers = &testCenters;
+        centerIndex.reset(new CenterSpatialIndex(testCenters));
+        roundingKm = matrix.getPrecision() == MatrixPrecision::Fixed16 ? matrix.getFixedResolution() / 2.0 : 0.0;
+    }
+
+    /**
+     * Find the nearest center that is not full
+     * @param personIndex Person index
+     * @param centerFull Full-center bitmap (nonzero = full)
+     * @return Pair of (centerIndex, distance) or (-1, -1) if none available
+     */
+    std::pair<int, double> findBestAvailable(int personIndex, const std::vector<char>& centerFull) {
+        std::vector<DistanceCandidate>& list = lists[personIndex];
+        unsigned int& position = cursor[personIndex];
+
+        if (list.empty() && position == 0) {
+            buildList(personIndex, centerFull);
+        }
+
+        while (true) {
+            while (position < list.size() && centerFull[list[position].centerIndex]) {
+                position++;
+                skippedFull++;
+            }
+            if (position < list.size()) {
+                if (list[position].distance < bound[personIndex]) {
+                    return std::make_pair(list[position].centerIndex, list[position].distance);
+                }
+                // An unlisted center could tie or be nearer once rounding is allowed for
+                scanRow(personIndex, centerFull);
+                continue;
+            }
+
+            // A short unbounded list already held every reachable open center
+            if (list.size() < listSize && std::isinf(bound[personIndex])) {
+                return std::make_pair(-1, -1.0);
+            }
+            rescans++;
+            buildList(personIndex, centerFull);
+        }
+    }
+
+    /**
+     * Drop all lists and cursors, e.g. after capacity was added to a center
+     */
+    void reset() {
+        for (std::vector<DistanceCandidate>& list : lists) {
+            std::vector<DistanceCandidate>().swap(list);
+        }
+        std::fill(cursor.begin(), cursor.end(), 0);
+        std::fill(bound.begin(), bound.end(), std::numeric_limits<float>::infinity());
+    }
+
+    /**
+     * Get selection statistics
+     * @return Lists built (from the index or by row scans), rescans of used-up
+     *         lists and full centers skipped
+     */
+    std::map<std::string, long long> getCursorStats() const {
+        std::map<std::string, long long> stats;
+        stats["lists_built"] = listsBuilt;
+        stats["indexed_lists"] = indexedLists;
+        stats["row_scans"] = rowScans;
+        stats["rescans"] = rescans;
+        stats["skipped_full"] = skippedFull;
+        stats["list_size"] = static_cast<long long>(listSize);
+        return stats;
+    }
+
+private:
+    void buildList(int personIndex, const std::vector<char>& centerFull) {
+        if (centerIndex) {
+            indexList(personIndex, centerFull);
+        } else {
+            scanRow(personIndex, centerFull);
+        }
+    }
+
+    /**
+     * List the k nearest open centers by straight-line distance, ordered by
+     * their matrix entries
+     * @param personIndex Person index
+     * @param centerFull Full-center bitmap
+     */
+    void indexList(int personIndex, const std::vector<char>& centerFull) {
+        std::vector<DistanceCandidate>& list = lists[personIndex];
+        const Point& person = (*people)[personIndex];
+        std::vector<int> nearest = centerIndex->findNearest(person, static_cast<int>(listSize),
+            [&centerFull](int center) { return !centerFull[center]; });
+
+        list.clear();
+        list.reserve(nearest.size());
+        for (int center : nearest) {
+            double distance = matrix.get(personIndex, center);
+            if (std::isfinite(distance)) list.emplace_back(center, distance);
+        }
+        std::sort(list.begin(), list.end(), [](const DistanceCandidate& a, const DistanceCandidate& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.centerIndex < b.centerIndex);
+        });
+
+        if (nearest.size() < listSize) {
+            bound[personIndex] = std::numeric_limits<float>::infinity(); // Every open center is listed
+        } else {
+            double farthest = person.distanceTo((*centers)[nearest.back()]);
+            bound[personIndex] = static_cast<float>(farthest * (1.0 - FLOAT_ROUNDING) - roundingKm);
+        }
+        cursor[personIndex] = 0;
+        listsBuilt++;
+        indexedLists++;
+    }
+
+    /**
+     * Select the k nearest open centers of a row with a bounded max-heap
+     * @param personIndex Person index
+     * @param centerFull Full-center bitmap
+     */
+    void scanRow(int personIndex, const std::vector<char>& centerFull) {
+        std::vector<DistanceCandidate>& list = lists[personIndex];
+        list.clear();
+        list.reserve(listSize);
+
+        auto farther = [](const DistanceCandidate& a, const DistanceCandidate& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.centerIndex < b.centerIndex);
+        };
+        auto offer = [&](int centerIndex, double distance) {
+            if (!std::isfinite(distance)) return;
+            if (list.size() < listSize) {
+                list.emplace_back(centerIndex, distance);
+                std::push_heap(list.begin(), list.end(), farther);
+            } else if (distance < list.front().distance) {
+                std::pop_heap(list.begin(), list.end(), farther);
+                list.back() = DistanceCandidate(centerIndex, distance);
+                std::push_heap(list.begin(), list.end(), farther);
+            }
+        };
+
+        size_t centerCount = matrix.getCenterCount();
+        if (matrix.getPrecision() == MatrixPrecision::Float32 && matrix.getLayout() == MatrixLayout::PersonMajor) {
+            const float* row = matrix.floatRow(personIndex);
+            for (size_t centerIndex = 0; centerIndex < centerCount; centerIndex++) {
+                if (!centerFull[centerIndex]) offer(centerIndex, row[centerIndex]);
+            }
+        } else {
+            for (size_t centerIndex = 0; centerIndex < centerCount; centerIndex++) {
+                if (!centerFull[centerIndex]) offer(centerIndex, matrix.get(personIndex, centerIndex));
+            }
+        }
+
+        std::sort_heap(list.begin(), list.end(), farther);
+        bound[personIndex] = std::numeric_limits<float>::infinity();
+        cursor[personIndex] = 0;
+        listsBuilt++;
+        rowScans++;
+    }
+};
+
+#endif // NEAREST_AVAILABLE_CURSOR_H
@@ -0,0 +1,532 @@
+#ifndef ONLINE_ASSIGNMENT_H
+#define ONLINE_ASSIGNMENT_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include "AssignmentAlgorithm.h"
+#include "CenterSpatialIndex.h"
+#include "StreamingStats.h"
+
+/**
+ * Answer of one online assignment request
+ */
+struct OnlineDecision {
+    int personId;
+    int centerIndex; // -1 if no center could take the person
+    double distance;
+
+    OnlineDecision(int id = -1, int center = -1, double d = 0.0) : personId(id), centerIndex(center), distance(d) {}
+};
+
+/**
+ * Online assignment for people registering one at a time.
+ *
+ * Capacities and a grid index over the centers that still have room stay
+ * in memory, so a request is one filtered nearest-center query (Haversine)
+ * under a short lock. The index is rebuilt over the open centers once half
+ * of its centers have filled, which keeps queries from wading through full
+ * cells as the service fills up.
+ *
+ * Every center holds back ceil(fraction * capacity) units for PWD people
+ * who have not registered yet: other people only take a center while its
+ * remaining capacity exceeds its outstanding reservation. The fraction is
+ * fixed or follows the PWD share observed so far, refreshed on every PWD
+ * arrival and every RESERVE_REFRESH_REQUESTS requests.
+ *
+ * Re-optimization runs the batch engine over a snapshot of everyone
+ * assigned so far without holding the lock. Back under the lock it frees
+ * the units of everyone whose center is unchanged since the snapshot and
+ * differs from the batch result, then places them at their batch centers
+ * in priority order (PWD first), so swaps and cycles go through. Anyone
+ * whose target was taken meanwhile returns to their old center. People who
+ * arrived or cancelled meanwhile are left alone. It can run on a background
+ * thread at a fixed interval; moved people are reported through a callback.
+ */
+class OnlineAssignmentService {
+public:
+    using ReassignmentCallback = std::function<void(int personId, int oldCenter, int newCenter)>;
+
+private:
+    static constexpr long long RESERVE_REFRESH_REQUESTS = 256; // Adaptive reserve refresh between PWD arrivals
+
+    struct PendingMove {
+        int personId;
+        int from; // Center at the snapshot, -1 if unassigned
+        int to;   // Batch center
+        double fromDistance;
+
+        PendingMove(int id, int f, int t, double d) : personId(id), from(f), to(t), fromDistance(d) {}
+    };
+
+    std::vector<Point> testCenters;
+    std::vector<int> capacity;
+    std::vector<int> remaining;
+    std::vector<int> pwdAssigned; // PWD people per center
+    std::vector<int> reserve;     // PWD units held back per center
+
+    double reserveFraction;
+    bool adaptiveReserve;
+    AssignmentEngine reoptimizationEngine;
+    int reoptimizationCandidates;
+    ReassignmentCallback onReassign;
+
+    // People in arrival order
+    std::vector<Point> people;
+    std::vector<int> assignedCenter; // -1 if unassigned or cancelled
+    std::vector<double> assignedDistance;
+    std::vector<char> active;
+    long long pwdArrivals;
+
+    // Grid index over the centers that had room when it was built
+    std::unique_ptr<CenterSpatialIndex> index;
+    std::vector<int> indexedCenters; // Index position -> center
+    std::vector<char> inIndex;
+    size_t fullIndexed;
+    bool indexStale; // A center outside the index has room again
+
+    mutable std::mutex stateMutex;
+    std::mutex reoptimizationMutex; // One re-optimization at a time
+
+    std::thread reoptimizer;
+    std::mutex timerMutex;
+    std::condition_variable timerSignal;
+    bool stopTimer;
+
+    // Counters
+    long long requests;
+    long long rejected;
+    long long indexRebuilds;
+    long long reoptimizations;
+    long long moved;
+    double lastGainKm;
+    double lastReoptimizationMs;
+    DistanceSketch latencyMicros;
+
+public:
+    /**
+     * @param centers Test centers
+     * @param capacities Capacity per center
+     */
+    OnlineAssignmentService(const std::vector<Point>& centers, const std::vector<int>& capacities)
+        : testCenters(centers)
+        , capacity(capacities)
+        , remaining(capacities)
+        , pwdAssigned(centers.size(), 0)
+        , reserve(centers.size(), 0)
+        , reserveFraction(0.0)
+        , adaptiveReserve(false)
+        , reoptimizationEngine(AssignmentEngine::MinCostFlow)
+        , reoptimizationCandidates(16)
+        , pwdArrivals(0)
+        , inIndex(centers.size(), 0)
+        , fullIndexed(0)
+        , indexStale(false)
+        , stopTimer(false)
+        , requests(0)
+        , rejected(0)
+        , indexRebuilds(0)
+        , reoptimizations(0)
+        , moved(0)
+        , lastGainKm(0.0)
+        , lastReoptimizationMs(0.0) {
+
+        if (capacities.size() != centers.size()) {
+            throw std::runtime_error("Online service needs one capacity per test center");
+        }
+        rebuildIndex();
+    }
+
+    ~OnlineAssignmentService() {
+        stopPeriodicReoptimization();
+    }
+
+    OnlineAssignmentService(const OnlineAssignmentService&) = delete;
+    OnlineAssignmentService& operator=(const OnlineAssignmentService&) = delete;
+
+    /**
+     * Hold back capacity for PWD people who have not registered yet
+     * @param fraction Share of each center's capacity reserved for PWD
+     * @param adaptive Follow the observed PWD share instead (fraction is the starting value)
+     */
+    void setPwdReservation(double fraction, bool adaptive = false) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        reserveFraction = std::min(std::max(fraction, 0.0), 1.0);
+        adaptiveReserve = adaptive;
+        updateReservations();
+    }
+
+    /**
+     * Choose the batch engine used by re-optimization
+     * @param engine Assignment engine
+     * @param candidates Nearest centers considered per person
+     */
+    void setReoptimization(AssignmentEngine engine, int candidates = 16) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        reoptimizationEngine = engine;
+        reoptimizationCandidates = std::max(candidates, 1);
+    }
+
+    /**
+     * Get told about people moved by re-optimization (called without the lock held)
+     */
+    void setReassignmentCallback(ReassignmentCallback callback) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        onReassign = callback;
+    }
+
+    /**
+     * Assign a newly registered person to the nearest center that can take them
+     * @param person Person (category decides PWD handling)
+     * @return Decision with the person id for later cancel or lookup
+     */
+    OnlineDecision assign(const Point& person) {
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(stateMutex);
+
+        bool pwd = person.category == "pwd";
+        int personId = static_cast<int>(people.size());
+        people.push_back(person);
+        assignedCenter.push_back(-1);
+        assignedDistance.push_back(0.0);
+        active.push_back(1);
+        requests++;
+        if (pwd) pwdArrivals++;
+        // A PWD arrival raises the observed share; other arrivals lower it slowly
+        if (adaptiveReserve && (pwd || requests % RESERVE_REFRESH_REQUESTS == 0)) {
+            updateReservations();
+        }
+
+        int centerIndex = findAvailable(person, pwd);
+        OnlineDecision decision(personId);
+        if (centerIndex == -1) {
+            rejected++;
+        } else {
+            double distance = person.distanceTo(testCenters[centerIndex]);
+            place(personId, centerIndex, distance);
+            decision.centerIndex = centerIndex;
+            decision.distance = distance;
+        }
+
+        latencyMicros.add(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        return decision;
+    }
+
+    /**
+     * Record a person already assigned elsewhere (e.g. by a batch run)
+     * @param person Person
+     * @param centerIndex Their center
+     * @return Person id
+     */
+    int seed(const Point& person, int centerIndex) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (centerIndex < 0 || centerIndex >= static_cast<int>(testCenters.size()) || remaining[centerIndex] <= 0) {
+            throw std::runtime_error("Cannot seed a person at test center " + std::to_string(centerIndex));
+        }
+        int personId = static_cast<int>(people.size());
+        people.push_back(person);
+        assignedCenter.push_back(-1);
+        assignedDistance.push_back(0.0);
+        active.push_back(1);
+        if (person.category == "pwd") pwdArrivals++;
+        place(personId, centerIndex, person.distanceTo(testCenters[centerIndex]));
+        return personId;
+    }
+
+    /**
+     * Cancel a registration and free its unit
+     * @param personId Person id
+     * @return False if the person does not exist or was already cancelled
+     */
+    bool cancel(int personId) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (personId < 0 || personId >= static_cast<int>(people.size()) || !active[personId]) return false;
+        active[personId] = 0;
+        unplace(personId);
+        return true;
+    }
+
+    /**
+     * Re-run the batch engine over everyone assigned so far and move people
+     * toward its result. Requests are served meanwhile.
+     * @return Number of people moved
+     */
+    int reoptimize() {
+        std::lock_guard<std::mutex> running(reoptimizationMutex);
+        auto start = std::chrono::steady_clock::now();
+
+        // Snapshot under the lock
+        std::vector<Point> snapshot;
+        std::vector<int> snapshotIds;
+        std::vector<int> snapshotCenters;
+        std::vector<int> capacities;
+        AssignmentEngine engine;
+        int candidates;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            for (size_t i = 0; i < people.size(); i++) {
+                if (active[i]) {
+                    snapshot.push_back(people[i]);
+                    snapshotIds.push_back(static_cast<int>(i));
+                    snapshotCenters.push_back(assignedCenter[i]);
+                }
+            }
+            capacities = capacity;
+            engine = reoptimizationEngine;
+            candidates = reoptimizationCandidates;
+        }
+        if (snapshot.empty()) return 0;
+
+        // Solve without the lock
+        AssignmentAlgorithm batch;
+        batch.setVerbose(false); // Runs on the re-optimization thread beside the caller's output
+        batch.setRoadDistanceEnabled(false);
+        batch.setCandidateCount(candidates);
+        batch.setAssignmentEngine(engine);
+        std::vector<std::vector<int>> slots(capacities.size());
+        for (size_t j = 0; j < capacities.size(); j++) {
+            slots[j].push_back(capacities[j]);
+        }
+        std::vector<AssignmentResult> results =
+            batch.assignPeopleToScheduledCenters(snapshot, testCenters, SlotSchedule(slots));
+
+        std::vector<std::pair<int, std::pair<int, int>>> applied; // (person id, (old, new))
+        ReassignmentCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+
+            // Move only people whose state is unchanged since the snapshot
+            std::vector<PendingMove> moves;
+            for (const auto& result : results) {
+                int personId = snapshotIds[result.personIndex];
+                int from = snapshotCenters[result.personIndex];
+                if (result.centerIndex == -1 || !active[personId] || assignedCenter[personId] != from ||
+                    from == result.centerIndex) {
+                    continue;
+                }
+                moves.push_back(PendingMove(personId, from, result.centerIndex, assignedDistance[personId]));
+            }
+            std::stable_partition(moves.begin(), moves.end(), [this](const PendingMove& move) {
+                return people[move.personId].category == "pwd";
+            });
+
+            // Free every mover's unit first so swaps and cycles within the batch result can close
+            for (const auto& move : moves) {
+                unplace(move.personId);
+            }
+
+            std::vector<std::vector<int>> entered(testCenters.size()); // Moves placed per center, in order
+            std::vector<int> returning;
+            for (size_t m = 0; m < moves.size(); m++) {
+                bool pwd = people[moves[m].personId].category == "pwd";
+                if (isAvailable(moves[m].to, pwd)) {
+                    place(moves[m].personId, moves[m].to, people[moves[m].personId].distanceTo(testCenters[moves[m].to]));
+                    entered[moves[m].to].push_back(static_cast<int>(m));
+                } else {
+                    returning.push_back(static_cast<int>(m));
+                }
+            }
+
+            // Put blocked people back; a unit they freed may have gone to a later
+            // move into their old center, which is then undone in turn
+            while (!returning.empty()) {
+                const PendingMove& move = moves[returning.back()];
+                returning.pop_back();
+                if (move.from == -1) continue;
+                while (remaining[move.from] == 0 && !entered[move.from].empty()) {
+                    int undone = entered[move.from].back();
+                    entered[move.from].pop_back();
+                    unplace(moves[undone].personId);
+                    returning.push_back(undone);
+                }
+                place(move.personId, move.from, move.fromDistance);
+            }
+
+            double gain = 0.0;
+            for (const auto& move : moves) {
+                int current = assignedCenter[move.personId];
+                if (current == move.from) continue;
+                gain += move.from == -1 ? 0.0 : move.fromDistance - assignedDistance[move.personId];
+                applied.push_back({move.personId, {move.from, current}});
+            }
+            if (adaptiveReserve) {
+                updateReservations();
+            }
+
+            reoptimizations++;
+            moved += applied.size();
+            lastGainKm = gain;
+            lastReoptimizationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            callback = onReassign;
+        }
+
+        if (callback) {
+            for (const auto& entry : applied) {
+                callback(entry.first, entry.second.first, entry.second.second);
+            }
+        }
+        return static_cast<int>(applied.size());
+    }
+
+    /**
+     * Re-optimize on a background thread every interval
+     * @param intervalSeconds Time between runs
+     */
+    void startPeriodicReoptimization(double intervalSeconds) {
+        stopPeriodicReoptimization();
+        stopTimer = false;
+        auto interval = std::chrono::duration<double>(std::max(intervalSeconds, 0.001));
+        reoptimizer = std::thread([this, interval]() {
+            std::unique_lock<std::mutex> lock(timerMutex);
+            while (!timerSignal.wait_for(lock, interval, [this]() { return stopTimer; })) {
+                lock.unlock();
+                reoptimize();
+                lock.lock();
+            }
+        });
+    }
+
+    void stopPeriodicReoptimization() {
+        if (!reoptimizer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            stopTimer = true;
+        }
+        timerSignal.notify_all();
+        reoptimizer.join();
+    }
+
+    int getAssignedCenter(int personId) const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return assignedCenter[personId];
+    }
+
+    double getAssignedDistance(int personId) const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return assignedDistance[personId];
+    }
+
+    int getRemainingCapacity(int centerIndex) const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return remaining[centerIndex];
+    }
+
+    /**
+     * Get service statistics
+     * @return Request, rejection, reservation, index and re-optimization
+     *         counters plus request latency quantiles in microseconds
+     */
+    std::map<std::string, double> getServiceStats() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        std::map<std::string, double> stats;
+        long long assigned = 0, outstanding = 0;
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] != -1) assigned++;
+        }
+        for (size_t j = 0; j < testCenters.size(); j++) {
+            outstanding += outstandingReserve(j);
+        }
+        stats["requests"] = requests;
+        stats["assigned"] = assigned;
+        stats["rejected"] = rejected;
+        stats["pwd_arrivals"] = pwdArrivals;
+        stats["reserve_fraction"] = reserveFraction;
+        stats["reserved_outstanding"] = outstanding;
+        stats["indexed_centers"] = indexedCenters.size();
+        stats["index_rebuilds"] = indexRebuilds;
+        stats["reoptimizations"] = reoptimizations;
+        stats["moved"] = moved;
+        stats["last_gain_km"] = lastGainKm;
+        stats["last_reoptimization_ms"] = lastReoptimizationMs;
+        stats["latency_mean_us"] = latencyMicros.getRunning().getMean();
+        stats["latency_p50_us"] = latencyMicros.quantile(0.50);
+        stats["latency_p99_us"] = latencyMicros.quantile(0.99);
+        stats["latency_max_us"] = latencyMicros.getRunning().getMax();
+        return stats;
+    }
+
+private:
+    int outstandingReserve(size_t centerIndex) const {
+        return std::max(reserve[centerIndex] - pwdAssigned[centerIndex], 0);
+    }
+
+    /**
+     * PWD people may use any remaining unit; others leave the outstanding
+     * PWD reservation untouched
+     */
+    bool isAvailable(int centerIndex, bool pwd) const {
+        return pwd ? remaining[centerIndex] > 0 : remaining[centerIndex] > outstandingReserve(centerIndex);
+    }
+
+    void updateReservations() {
+        if (adaptiveReserve && requests > 0) {
+            reserveFraction = static_cast<double>(pwdArrivals) / requests;
+        }
+        for (size_t j = 0; j < capacity.size(); j++) {
+            reserve[j] = static_cast<int>(std::ceil(reserveFraction * capacity[j]));
+        }
+    }
+
+    int findAvailable(const Point& person, bool pwd) {
+        if (indexStale || fullIndexed * 2 > indexedCenters.size()) {
+            rebuildIndex();
+        }
+        std::vector<int> nearest = index->findNearest(person, 1, [this, pwd](int position) {
+            return isAvailable(indexedCenters[position], pwd);
+        });
+        return nearest.empty() ? -1 : indexedCenters[nearest[0]];
+    }
+
+    /**
+     * Index the centers that still have room
+     */
+    void rebuildIndex() {
+        std::vector<Point> open;
+        indexedCenters.clear();
+        std::fill(inIndex.begin(), inIndex.end(), 0);
+        for (size_t j = 0; j < testCenters.size(); j++) {
+            if (remaining[j] > 0) {
+                indexedCenters.push_back(static_cast<int>(j));
+                open.push_back(testCenters[j]);
+                inIndex[j] = 1;
+            }
+        }
+        index.reset(new CenterSpatialIndex(open));
+        fullIndexed = 0;
+        indexStale = false;
+        indexRebuilds++;
+    }
+
+    void place(int personId, int centerIndex, double distance) {
+        assignedCenter[personId] = centerIndex;
+        assignedDistance[personId] = distance;
+        if (people[personId].category == "pwd") pwdAssigned[centerIndex]++;
+        if (--remaining[centerIndex] == 0 && inIndex[centerIndex]) fullIndexed++;
+    }
+
+    void unplace(int personId) {
+        int centerIndex = assignedCenter[personId];
+        if (centerIndex == -1) return;
+        assignedCenter[personId] = -1;
+        assignedDistance[personId] = 0.0;
+        if (people[personId].category == "pwd") pwdAssigned[centerIndex]--;
+        if (remaining[centerIndex]++ == 0) {
+            if (inIndex[centerIndex]) {
+                fullIndexed--;
+            } else {
+                indexStale = true;
+            }
+        }
+    }
+};
+
+#endif // ONLINE_ASSIGNMENT_H
@@ -0,0 +1,105 @@
+#ifndef PERSON_SOURCE_H
+#define PERSON_SOURCE_H
+
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "RandomPointGenerator.h"
+
+/**
+ * Sequential, restartable stream of people for streaming assignment.
+ * Streaming passes over the source once per priority tier, so a source must
+ * return the same people in the same order after every reset().
+ */
+class PersonSource {
+public:
+    virtual ~PersonSource() = default;
+
+    /**
+     * Read the next person
+     * @param person Filled with the next person
+     * @return False at end of stream
+     */
+    virtual bool next(Point& person) = 0;
+
+    /**
+     * Rewind to the first person
+     */
+    virtual void reset() = 0;
+};
+
+/**
+ * Person source over an in-memory vector (must outlive the source)
+ */
+class VectorPersonSource : public PersonSource {
+private:
+    const std::vector<Point>& people;
+    size_t position;
+
+public:
+    explicit VectorPersonSource(const std::vector<Point>& p) : people(p), position(0) {}
+
+    bool next(Point& person) override {
+        if (position >= people.size()) return false;
+        person = people[position++];
+        return true;
+    }
+
+    void reset() override {
+        position = 0;
+    }
+};
+
+/**
+ * Person source reading 'lat,lng,category' lines from a CSV file.
+ * Lines that do not start with two numbers (headers, blanks) are skipped;
+ * a missing category defaults to "male".
+ */
+class CsvPersonSource : public PersonSource {
+private:
+    std::string path;
+    std::ifstream input;
+    std::string line;
+
+public:
+    /**
+     * @param filePath CSV file
+     */
+    explicit CsvPersonSource(const std::string& filePath) : path(filePath), input(filePath) {
+        if (!input) {
+            throw std::runtime_error("Cannot open people file: " + path);
+        }
+    }
+
+    bool next(Point& person) override {
+        while (std::getline(input, line)) {
+            std::istringstream stream(line);
+            std::string latitude, longitude, category;
+            if (!std::getline(stream, latitude, ',') || !std::getline(stream, longitude, ',')) continue;
+            std::getline(stream, category, ',');
+
+            char* end = nullptr;
+            double lat = std::strtod(latitude.c_str(), &end);
+            if (end == latitude.c_str()) continue;
+            double lng = std::strtod(longitude.c_str(), &end);
+            if (end == longitude.c_str()) continue;
+
+            while (!category.empty() && (category.back() == '\r' || category.back() == ' ')) {
+                category.pop_back();
+            }
+            person = Point(lat, lng, "person", category.empty() ? "male" : category);
+            return true;
+        }
+        return false;
+    }
+
+    void reset() override {
+        input.clear();
+        input.seekg(0);
+    }
+};
+
+#endif // PERSON_SOURCE_H
@@ -2,6 +2,7 @@
 #define RANDOM_POINT_GENERATOR_H
 
 #include <vector>
+#include <string>
 #include <random>
 #include <cmath>
 #include <chrono>
@@ -15,6 +16,25 @@ struct Point {
 
     Point(double lat = 0.0, double lng = 0.0, const std::string& t = "person", const std::string& c = "male") 
         : latitude(lat), longitude(lng), type(t), category(c) {}
+
+    // Calculate Haversine distance to another point
+    double distanceTo(const Point& other) const {
+        const double R = 6371.0; // Earth's radius in km
+        double dLat = degreesToRadians(other.latitude - latitude);
+        double dLng = degreesToRadians(other.longitude - longitude);
+        
+        double a = std::sin(dLat/2) * std::sin(dLat/2) +
+                   std::cos(degreesToRadians(latitude)) * std::cos(degreesToRadians(other.latitude)) *
+                   std::sin(dLng/2) * std::sin(dLng/2);
+        
+        double c = 2 * std::atan2(std::sqrt(a), std::sqrt(1-a));
+        return R * c;
+    }
+
+private:
+    double degreesToRadians(double degrees) const {
+        return degrees * M_PI / 180.0;
+    }
 };
 
 class RandomPointGenerator {
@@ -0,0 +1,528 @@
+#ifndef REGIONAL_ASSIGNMENT_H
+#define REGIONAL_ASSIGNMENT_H
+
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "CandidateDistanceMatrix.h"
+#include "CenterSpatialIndex.h"
+
+/**
+ * Geographic decomposition for large assignments.
+ *
+ * People are split into regions by a k-d tree (median cuts along the wider
+ * side). Each region sees the centers inside its bounding box widened by an
+ * overlap margin, so people near a border can still reach centers across
+ * it, and is assigned greedily in priority order over k-nearest candidate
+ * lists, in parallel with the other regions.
+ *
+ * Overlapping regions may both fill a shared center. The reconciliation
+ * pass keeps each center's best claims (by tier, then distance) up to its
+ * capacity and re-places everyone else globally, in priority order, at the
+ * nearest center that still has room; a person of a higher tier may bump a
+ * lower-tier occupant of a nearby center when nothing is free.
+ *
+ * On request the result is compared, tier by tier, with a global greedy run
+ * over the same candidate distances and capacities, so the cost of
+ * decomposing is measured rather than assumed. The check is serial and
+ * repeats every distance query, so it is off by default and timed
+ * separately (gap_ms). Every tier can lose, the first one
+ * included: a person displaced from a shared center is re-placed only
+ * among the nearest centers still free after the regions have run, which
+ * the global run would have offered to them before anyone of a later tier
+ * or region. A later tier can also gain from what an earlier one lost. The
+ * sum of nearest-center distances is reported too, but it ignores capacity
+ * and is not a bound the assignment can reach.
+ */
+class RegionalAssignment {
+public:
+    using DistanceFunction = std::function<double(const Point&, const Point&)>;
+
+private:
+    static constexpr double KM_PER_DEGREE = 111.19;
+    static constexpr int REPAIR_CANDIDATES = 8; // Centers tried per re-placed person
+
+    struct Region {
+        std::vector<int> people;  // Global person indices in priority order
+        std::vector<int> centers; // Global center indices
+        double minLat, maxLat, minLng, maxLng;
+        std::vector<int> assignedCenter; // Global center per region person, -1 if none
+        std::vector<double> assignedDistance;
+    };
+
+    const std::vector<Point>& people;
+    const std::vector<Point>& testCenters;
+    std::vector<int> tier;
+    std::vector<int> capacity;
+    DistanceFunction exactDistance;
+    int candidateCount;
+    int regionCount;
+    double overlapKm;
+    int threadCount;
+    bool compareGlobal;
+    std::vector<DistanceFunction> workerDistances; // One per solving thread (empty = exactDistance)
+
+    std::vector<Region> regions;
+    std::vector<int> assignedCenter;
+    std::vector<double> assignedDistance;
+    std::map<std::string, double> stats;
+
+public:
+    /**
+     * @param p People
+     * @param centers Test centers
+     * @param tiers Priority tier per person (0 is served first)
+     * @param capacities Capacity per center
+     * @param distanceFn Exact distance; must be safe to call from several
+     *                   threads unless per-thread functions are set
+     * @param k Candidates per person
+     * @param regionTarget Number of regions
+     * @param overlap Border overlap in km
+     */
+    RegionalAssignment(const std::vector<Point>& p, const std::vector<Point>& centers,
+                       const std::vector<int>& tiers, const std::vector<int>& capacities,
+                       DistanceFunction distanceFn, int k, int regionTarget, double overlap)
+        : people(p)
+        , testCenters(centers)
+        , tier(tiers)
+        , capacity(capacities)
+        , exactDistance(distanceFn)
+        , candidateCount(std::max(k, 1))
+        , regionCount(std::max(regionTarget, 1))
+        , overlapKm(std::max(overlap, 0.0))
+        , threadCount(std::max(1u, std::thread::hardware_concurrency()))
+        , compareGlobal(false)
+        , assignedCenter(p.size(), -1)
+        , assignedDistance(p.size(), 0.0) {
+
+        for (int& units : capacity) {
+            units = std::max(units, 0);
+        }
+    }
+
+    /**
+     * Set number of threads solving regions
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void setThreadCount(int threads) {
+        threadCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Give each region thread its own distance function (e.g. its own road
+     * service), so region solves do not contend for one. The number of
+     * functions caps the thread count; reconciliation and the gap check
+     * use the constructor's function.
+     * @param distances Exact distance functions, one per thread
+     */
+    void setWorkerDistances(const std::vector<DistanceFunction>& distances) {
+        workerDistances = distances;
+    }
+
+    /**
+     * Compare every solve with a global greedy run (serial, costs about as
+     * many distance queries as the regional run itself)
+     * @param enabled Whether solve() measures the gap
+     */
+    void setGlobalComparison(bool enabled) {
+        compareGlobal = enabled;
+    }
+
+    /**
+     * Partition, solve the regions in parallel and reconcile their borders
+     */
+    void solve() {
+        auto start = std::chrono::steady_clock::now();
+        stats.clear();
+
+        std::vector<int> order(people.size());
+        for (size_t i = 0; i < people.size(); i++) {
+            order[i] = static_cast<int>(i);
+        }
+        regions.clear();
+        if (!people.empty() && !testCenters.empty()) {
+            splitRegions(order, 0, order.size(), std::min<int>(regionCount, static_cast<int>(people.size())));
+        }
+        attachCenters();
+        auto partitioned = std::chrono::steady_clock::now();
+
+        solveRegions();
+        auto solved = std::chrono::steady_clock::now();
+
+        reconcile();
+        auto reconciled = std::chrono::steady_clock::now();
+
+        size_t maxPeople = 0, maxCenters = 0, centerCopies = 0;
+        for (const Region& region : regions) {
+            maxPeople = std::max(maxPeople, region.people.size());
+            maxCenters = std::max(maxCenters, region.centers.size());
+            centerCopies += region.centers.size();
+        }
+        stats["regions"] = static_cast<double>(regions.size());
+        stats["threads"] = threadCount;
+        stats["max_region_people"] = static_cast<double>(maxPeople);
+        stats["max_region_centers"] = static_cast<double>(maxCenters);
+        stats["overlap_centers"] = static_cast<double>(centerCopies) - static_cast<double>(testCenters.size());
+        stats["partition_ms"] = std::chrono::duration<double, std::milli>(partitioned - start).count();
+        stats["solve_ms"] = std::chrono::duration<double, std::milli>(solved - partitioned).count();
+        stats["reconcile_ms"] = std::chrono::duration<double, std::milli>(reconciled - solved).count();
+        measureGap();
+        stats["gap_ms"] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - reconciled).count();
+    }
+
+    /**
+     * Get assigned center of a person
+     * @param personIndex Person index
+     * @return Center index or -1
+     */
+    int getAssignedCenter(int personIndex) const {
+        return assignedCenter[personIndex];
+    }
+
+    /**
+     * Get distance of a person's assignment
+     * @param personIndex Person index
+     * @return Distance in km (0 if unassigned)
+     */
+    double getAssignedDistance(int personIndex) const {
+        return assignedDistance[personIndex];
+    }
+
+    /**
+     * Get decomposition statistics
+     * @return Region sizes, conflicts, repairs and phase times; total and
+     *         per-tier ("tier<N>_...") distance and assigned counts; with the
+     *         global comparison also those of the global run, the gap between
+     *         them and the uncapacitated nearest-center sum
+     */
+    std::map<std::string, double> getRegionStats() const {
+        return stats;
+    }
+
+private:
+    double lngScale(double latitude) const {
+        return std::max(std::cos(latitude * M_PI / 180.0), 0.01);
+    }
+
+    /**
+     * Split people [begin, end) of order into the given number of leaves,
+     * cutting at the (leaf-weighted) median of the wider side
+     */
+    void splitRegions(std::vector<int>& order, size_t begin, size_t end, int leaves) {
+        double minLat = people[order[begin]].latitude, maxLat = minLat;
+        double minLng = people[order[begin]].longitude, maxLng = minLng;
+        for (size_t i = begin; i < end; i++) {
+            const Point& person = people[order[i]];
+            minLat = std::min(minLat, person.latitude);
+            maxLat = std::max(maxLat, person.latitude);
+            minLng = std::min(minLng, person.longitude);
+            maxLng = std::max(maxLng, person.longitude);
+        }
+
+        if (leaves <= 1 || end - begin < 2) {
+            Region region;
+            region.people.assign(order.begin() + begin, order.begin() + end);
+            region.minLat = minLat;
+            region.maxLat = maxLat;
+            region.minLng = minLng;
+            region.maxLng = maxLng;
+            regions.push_back(std::move(region));
+            return;
+        }
+
+        bool byLatitude = (maxLat - minLat) >= (maxLng - minLng) * lngScale((minLat + maxLat) / 2);
+        int leftLeaves = leaves / 2;
+        size_t middle = begin + (end - begin) * leftLeaves / leaves;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](int a, int b) {
+            return byLatitude ? people[a].latitude < people[b].latitude : people[a].longitude < people[b].longitude;
+        });
+
+        splitRegions(order, begin, middle, leftLeaves);
+        splitRegions(order, middle, end, leaves - leftLeaves);
+    }
+
+    /**
+     * Give every region the centers inside its widened bounding box and put
+     * its people in priority order
+     */
+    void attachCenters() {
+        for (Region& region : regions) {
+            double latMargin = overlapKm / KM_PER_DEGREE;
+            double lngMargin = latMargin / lngScale(std::max(std::abs(region.minLat), std::abs(region.maxLat)));
+            for (size_t j = 0; j < testCenters.size(); j++) {
+                const Point& center = testCenters[j];
+                if (center.latitude >= region.minLat - latMargin && center.latitude <= region.maxLat + latMargin &&
+                    center.longitude >= region.minLng - lngMargin && center.longitude <= region.maxLng + lngMargin) {
+                    region.centers.push_back(j);
+                }
+            }
+
+            // A region with no center inside its box borrows the ones nearest to it
+            if (region.centers.empty()) {
+                CenterSpatialIndex spatialIndex(testCenters);
+                Point middle((region.minLat + region.maxLat) / 2, (region.minLng + region.maxLng) / 2);
+                region.centers = spatialIndex.findNearest(middle, candidateCount);
+            }
+
+            std::sort(region.people.begin(), region.people.end(), [this](int a, int b) {
+                return tier[a] != tier[b] ? tier[a] < tier[b] : a < b;
+            });
+        }
+    }
+
+    void solveRegions() {
+        std::atomic<size_t> nextRegion(0);
+        auto worker = [&](int t) {
+            const DistanceFunction& distance = workerDistances.empty() ? exactDistance : workerDistances[t];
+            for (size_t r = nextRegion++; r < regions.size(); r = nextRegion++) {
+                solveRegion(regions[r], distance);
+            }
+        };
+
+        int threads = std::min<int>(threadCount, static_cast<int>(regions.size()));
+        if (!workerDistances.empty()) {
+            threads = std::min<int>(threads, static_cast<int>(workerDistances.size()));
+        }
+        if (threads <= 1) {
+            worker(0);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back(worker, t);
+        }
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Greedy priority assignment of one region over its own centers, each
+     * at full capacity
+     * @param region Region to solve
+     * @param distance Exact distance function of the calling thread
+     */
+    void solveRegion(Region& region, const DistanceFunction& distance) {
+        std::vector<Point> localPeople;
+        std::vector<Point> localCenters;
+        std::vector<int> localCapacity;
+        localPeople.reserve(region.people.size());
+        for (int personIndex : region.people) {
+            localPeople.push_back(people[personIndex]);
+        }
+        for (int centerIndex : region.centers) {
+            localCenters.push_back(testCenters[centerIndex]);
+            localCapacity.push_back(capacity[centerIndex]);
+        }
+
+        CandidateDistanceMatrix candidateMatrix(localPeople, localCenters, candidateCount, distance);
+        region.assignedCenter.assign(localPeople.size(), -1);
+        region.assignedDistance.assign(localPeople.size(), 0.0);
+
+        for (size_t i = 0; i < localPeople.size(); i++) {
+            auto best = candidateMatrix.findBestAvailable(i, [&localCapacity](int centerIndex) {
+                return localCapacity[centerIndex] > 0;
+            });
+            if (best.first == -1) continue;
+            localCapacity[best.first]--;
+            region.assignedCenter[i] = region.centers[best.first];
+            region.assignedDistance[i] = best.second;
+        }
+    }
+
+    /**
+     * Keep each center's best claims up to capacity and re-place the rest
+     * (and people their region could not serve) in priority order
+     */
+    void reconcile() {
+        std::vector<std::vector<int>> claims(testCenters.size());
+        std::vector<int> unplaced;
+        for (const Region& region : regions) {
+            for (size_t i = 0; i < region.people.size(); i++) {
+                int personIndex = region.people[i];
+                if (region.assignedCenter[i] == -1) {
+                    unplaced.push_back(personIndex);
+                    continue;
+                }
+                assignedCenter[personIndex] = region.assignedCenter[i];
+                assignedDistance[personIndex] = region.assignedDistance[i];
+                claims[region.assignedCenter[i]].push_back(personIndex);
+            }
+        }
+
+        std::vector<std::vector<int>> members(testCenters.size());
+        std::vector<int> freeUnits(capacity);
+        long long conflicts = 0;
+        for (size_t j = 0; j < testCenters.size(); j++) {
+            std::vector<int>& claimed = claims[j];
+            if (static_cast<int>(claimed.size()) > capacity[j]) {
+                std::sort(claimed.begin(), claimed.end(), [this](int a, int b) {
+                    if (tier[a] != tier[b]) return tier[a] < tier[b];
+                    return assignedDistance[a] != assignedDistance[b] ? assignedDistance[a] < assignedDistance[b] : a < b;
+                });
+                for (size_t c = capacity[j]; c < claimed.size(); c++) {
+                    assignedCenter[claimed[c]] = -1;
+                    assignedDistance[claimed[c]] = 0.0;
+                    unplaced.push_back(claimed[c]);
+                    conflicts++;
+                }
+                claimed.resize(capacity[j]);
+            }
+            members[j] = claimed;
+            freeUnits[j] -= static_cast<int>(claimed.size());
+        }
+
+        long long repaired = 0, bumped = 0;
+        CenterSpatialIndex spatialIndex(testCenters);
+        auto laterInOrder = [this](int a, int b) {
+            return tier[a] != tier[b] ? tier[a] > tier[b] : a > b;
+        };
+        std::set<int, decltype(laterInOrder)> queue(unplaced.begin(), unplaced.end(), laterInOrder);
+
+        while (!queue.empty()) {
+            int personIndex = *queue.rbegin();
+            queue.erase(std::prev(queue.end()));
+
+            std::vector<int> nearest = spatialIndex.findNearest(people[personIndex], REPAIR_CANDIDATES,
+                [&freeUnits](int centerIndex) { return freeUnits[centerIndex] > 0; });
+            int bestCenter = -1;
+            double bestDistance = 0.0;
+            for (int centerIndex : nearest) {
+                double distance = exactDistance(people[personIndex], testCenters[centerIndex]);
+                if (bestCenter == -1 || distance < bestDistance) {
+                    bestCenter = centerIndex;
+                    bestDistance = distance;
+                }
+            }
+
+            if (bestCenter == -1) {
+                // Nothing free anywhere: take the place of the farthest
+                // lowest-tier occupant among the nearest centers
+                int victim = -1;
+                for (int centerIndex : spatialIndex.findNearest(people[personIndex], REPAIR_CANDIDATES)) {
+                    for (int occupant : members[centerIndex]) {
+                        if (tier[occupant] <= tier[personIndex]) continue;
+                        if (victim == -1 || tier[occupant] > tier[victim] ||
+                            (tier[occupant] == tier[victim] && assignedDistance[occupant] > assignedDistance[victim])) {
+                            victim = occupant;
+                        }
+                    }
+                }
+                if (victim == -1) continue;
+
+                bestCenter = assignedCenter[victim];
+                bestDistance = exactDistance(people[personIndex], testCenters[bestCenter]);
+                std::vector<int>& victimCenter = members[bestCenter];
+                victimCenter.erase(std::find(victimCenter.begin(), victimCenter.end(), victim));
+                freeUnits[bestCenter]++;
+                assignedCenter[victim] = -1;
+                assignedDistance[victim] = 0.0;
+                queue.insert(victim);
+                bumped++;
+            }
+
+            assignedCenter[personIndex] = bestCenter;
+            assignedDistance[personIndex] = bestDistance;
+            members[bestCenter].push_back(personIndex);
+            freeUnits[bestCenter]--;
+            repaired++;
+        }
+
+        stats["conflicts"] = static_cast<double>(conflicts);
+        stats["repaired"] = static_cast<double>(repaired);
+        stats["bumped"] = static_cast<double>(bumped);
+    }
+
+    /**
+     * Gap of the mean distance per assigned person to a reference run
+     */
+    static double gapPercent(double km, double assigned, double referenceKm, double referenceAssigned) {
+        if (assigned <= 0 || referenceAssigned <= 0 || referenceKm <= 0) return 0.0;
+        double reference = referenceKm / referenceAssigned;
+        return 100.0 * (km / assigned - reference) / reference;
+    }
+
+    /**
+     * Record total and per-tier distance; with the global comparison, also
+     * run a global greedy assignment (priority order, nearest candidate with
+     * room, same k and capacities) and sum the uncapacitated nearest-center
+     * distances (Haversine)
+     */
+    void measureGap() {
+        int tierCount = 1;
+        for (size_t i = 0; i < people.size(); i++) {
+            tierCount = std::max(tierCount, tier[i] + 1);
+        }
+        std::vector<double> regionalKm(tierCount, 0.0), regionalAssigned(tierCount, 0.0);
+        for (size_t i = 0; i < people.size(); i++) {
+            if (assignedCenter[i] == -1) continue;
+            regionalKm[tier[i]] += assignedDistance[i];
+            regionalAssigned[tier[i]]++;
+        }
+
+        double total = 0, assigned = 0;
+        for (int t = 0; t < tierCount; t++) {
+            std::string prefix = "tier" + std::to_string(t) + "_";
+            stats[prefix + "km"] = regionalKm[t];
+            stats[prefix + "assigned"] = regionalAssigned[t];
+            total += regionalKm[t];
+            assigned += regionalAssigned[t];
+        }
+        stats["tiers"] = tierCount;
+        stats["assigned"] = assigned;
+        stats["total_km"] = total;
+        if (!compareGlobal) return;
+
+        std::vector<int> order(people.size());
+        for (size_t i = 0; i < people.size(); i++) {
+            order[i] = static_cast<int>(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return tier[a] < tier[b];
+        });
+
+        CandidateDistanceMatrix global(people, testCenters, candidateCount, exactDistance);
+        std::vector<int> globalRemaining(capacity);
+        std::vector<double> globalKm(tierCount, 0.0), globalAssigned(tierCount, 0.0);
+        CenterSpatialIndex spatialIndex(testCenters);
+        double lowerBound = 0;
+        for (int personIndex : order) {
+            int t = tier[personIndex];
+            std::pair<int, double> best = global.findBestAvailable(personIndex, [&globalRemaining](int centerIndex) {
+                return globalRemaining[centerIndex] > 0;
+            });
+            if (best.first != -1) {
+                globalRemaining[best.first]--;
+                globalKm[t] += best.second;
+                globalAssigned[t]++;
+            }
+
+            if (assignedCenter[personIndex] == -1) continue;
+            std::vector<int> nearest = spatialIndex.findNearest(people[personIndex], 1);
+            lowerBound += people[personIndex].distanceTo(testCenters[nearest[0]]);
+        }
+
+        double globalTotal = 0, globalCount = 0;
+        for (int t = 0; t < tierCount; t++) {
+            std::string prefix = "tier" + std::to_string(t) + "_";
+            stats[prefix + "global_km"] = globalKm[t];
+            stats[prefix + "global_assigned"] = globalAssigned[t];
+            stats[prefix + "gap_pct"] = gapPercent(regionalKm[t], regionalAssigned[t], globalKm[t], globalAssigned[t]);
+            globalTotal += globalKm[t];
+            globalCount += globalAssigned[t];
+        }
+        stats["global_assigned"] = globalCount;
+        stats["global_km"] = globalTotal;
+        stats["gap_pct"] = gapPercent(total, assigned, globalTotal, globalCount);
+        stats["uncapacitated_km"] = lowerBound;
+    }
+};
+
+#endif // REGIONAL_ASSIGNMENT_H
@@ -9,182 +9,201 @@
 #include <thread>
 #include <future>
 #include <iostream>
-#include <sstream>
-#include <curl/curl.h>
-#include "AStarAlgorithm.h"
-
-struct Point {
-    double latitude;
-    double longitude;
-    std::string type;      // "person" or "test_center"
-    std::string category;  // "male", "female", "pwd" for people; "center" for test centers
-
-    Point(double lat = 0.0, double lng = 0.0, const std::string& t = "person", const std::string& c = "male") 
-        : latitude(lat), longitude(lng), type(t), category(c) {}
-
-    // Calculate Haversine distance to another point
-    double distanceTo(const Point& other) const {
-        const double R = 6371.0; // Earth's radius in km
-        double dLat = degreesToRadians(other.latitude - latitude);
-        double dLng = degreesToRadians(other.longitude - longitude);
-        
-        double a = std::sin(dLat/2) * std::sin(dLat/2) +
-                   std::cos(degreesToRadians(latitude)) * std::cos(degreesToRadians(other.latitude)) *
-                   std::sin(dLng/2) * std::sin(dLng/2);
-        
-        double c = 2 * std::atan2(std::sqrt(a), std::sqrt(1-a));
-        return R * c;
-    }
-
-private:
-    double degreesToRadians(double degrees) const {
-        return degrees * M_PI / 180.0;
-    }
-};
-
-struct CacheEntry {
-    double distance;
-    std::chrono::steady_clock::time_point timestamp;
-    
-    CacheEntry(double dist) : distance(dist), timestamp(std::chrono::steady_clock::now()) {}
-    
-    bool isExpired(int timeoutMs = 300000) const { // 5 minutes default
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - timestamp);
-        return elapsed.count() > timeoutMs;
-    }
-};
+#include <stdexcept>
+#include <memory>
+#include "DistanceQueryPlanner.h"
+#include "DistanceMatrix.h"
+#include "CoordinateSnapper.h"
+#include "MatrixCheckpoint.h"
+#include "DistanceCache.h"
 
 class RoadDistanceService {
 private:
-    std::string baseUrl;
-    std::map<std::string, CacheEntry> cache;
-    int cacheTimeout;
+    std::shared_ptr<DistanceCache> cache;
     int batchSize;
-    CURL* curl;
-    AStarAlgorithm aStarAlgorithm;
-    bool useAStar;
+    size_t tileRows;
+    std::string checkpointFile;
+    CoordinateSnapper coordinateSnapper;
+    DistanceQueryPlanner queryPlanner;
+    std::shared_ptr<GridAStarBackend> aStarBackend;
+    std::shared_ptr<OSRMBackend> osrmBackend;
     
     // Progress callback function type
     std::function<void(int, int, const std::string&)> progressCallback;
-    
-    // HTTP response callback for libcurl
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
-        size_t newLength = size * nmemb;
-        try {
-            s->append((char*)contents, newLength);
-            return newLength;
-        } catch(std::bad_alloc &e) {
-            return 0;
-        }
+
+    /**
+     * Worker sharing the cache of a parent service (see createWorker)
+     */
+    RoadDistanceService(const RoadDistanceService& parent, std::shared_ptr<OSRMBackend> workerOsrm)
+        : cache(parent.cache)
+        , batchSize(parent.batchSize)
+        , tileRows(parent.tileRows)
+        , coordinateSnapper(parent.coordinateSnapper)
+        , queryPlanner(parent.queryPlanner)
+        , aStarBackend(std::make_shared<GridAStarBackend>(*parent.aStarBackend))
+        , osrmBackend(workerOsrm) {
+
+        queryPlanner.replaceBackend(parent.aStarBackend, aStarBackend);
+        queryPlanner.replaceBackend(parent.osrmBackend, osrmBackend);
     }
 
 public:
     RoadDistanceService() 
-        : baseUrl("https://router.project-osrm.org/route/v1/driving")
-        , cacheTimeout(300000) // 5 minutes
+        : cache(std::make_shared<DistanceCache>(300000)) // 5 minutes
         , batchSize(25)
-        , curl(nullptr)
-        , useAStar(true) {
+        , tileRows(256)
+        , aStarBackend(std::make_shared<GridAStarBackend>())
+        , osrmBackend(std::make_shared<OSRMBackend>()) {
         
-        // Initialize libcurl
-        curl_global_init(CURL_GLOBAL_DEFAULT);
-        curl = curl_easy_init();
+        // One cache for every backend; standalone A* lookups read the same entries
+        aStarBackend->getAStarAlgorithm().setDistanceCache(cache);
         
-        if (curl) {
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L); // 10 second timeout
-            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L); // 5 second connect timeout
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, "RouteAnalyzer/1.0");
-        }
+        // Priors reproduce the fixed policy (A* under 50 km, else OSRM) until
+        // measurements for a distance band are available
+        queryPlanner.addBackend(std::make_shared<HaversineBackend>(), 0.001, 0.3);
+        queryPlanner.addBackend(aStarBackend, 1.0, 0.1, 50.0);
+        queryPlanner.addBackend(osrmBackend, 200.0, 0.0);
     }
-    
-    ~RoadDistanceService() {
-        if (curl) {
-            curl_easy_cleanup(curl);
-        }
-        curl_global_cleanup();
+
+    RoadDistanceService(const RoadDistanceService&) = delete;
+    RoadDistanceService& operator=(const RoadDistanceService&) = delete;
+
+    /**
+     * Create a service for another thread. It shares the distance cache
+     * (including the persistent store), copies snapping and the planner's
+     * priors and measurements, and gets its own A* and OSRM backends and HTTP
+     * connection. Backends the caller added to the planner stay shared and
+     * must be safe for concurrent use.
+     * @return Worker service, or null if the HTTP transport cannot be
+     *         duplicated (recording and replay transports)
+     */
+    std::unique_ptr<RoadDistanceService> createWorker() const {
+        std::shared_ptr<OSRMBackend> workerOsrm = osrmBackend->createWorker();
+        if (!workerOsrm) return nullptr;
+        return std::unique_ptr<RoadDistanceService>(new RoadDistanceService(*this, workerOsrm));
     }
 
     /**
-     * Calculate road distance between two points using A* or OSRM
+     * Calculate road distance between two points using the backend chosen by the query planner
      * @param point1 First point
      * @param point2 Second point
      * @return Road distance in kilometers
      */
     double calculateRoadDistance(const Point& point1, const Point& point2) {
-        std::string cacheKey = getCacheKey(point1, point2);
-        
-        // Check cache first
-        auto it = cache.find(cacheKey);
-        if (it != cache.end() && !it->second.isExpired(cacheTimeout)) {
-            return it->second.distance;
-        }
+        // Snap coordinates so that nearby points share cache entries and routes
+        auto [snapped1, snapped2] = coordinateSnapper.snapPair(point1, point2);
         
-        try {
-            double distance;
-            
-            // Use A* for short distances, OSRM for long distances
-            if (useAStar && point1.distanceTo(point2) < 50.0) {
-                distance = aStarAlgorithm.findPath(point1, point2);
-            } else {
-                distance = calculateOSRMDistance(point1, point2);
-            }
-            
-            // Cache the result
-            cache[cacheKey] = CacheEntry(distance);
-            
-            return distance;
-        } catch (const std::exception& e) {
-            std::cerr << "Road distance calculation failed: " << e.what() << std::endl;
-            // Fallback to Haversine distance
-            return point1.distanceTo(point2);
-        }
+        // Check cache first; the planner falls back to Haversine distance if the
+        // chosen backend fails, and such estimates are not cached
+        return cache->getOrCompute(snapped1, snapped2, [&]() {
+            return queryPlanner.planDistance(snapped1, snapped2);
+        });
     }
 
     /**
      * Calculate distance matrix for all people and test centers
      * @param people Vector of people points
      * @param testCenters Vector of test center points
-     * @return Distance matrix [personIndex][centerIndex]
+     * @param precision Matrix storage precision
+     * @param layout Matrix storage layout
+     * @param resolutionKm Initial kilometers per unit for Fixed16 (see DistanceMatrix::fixedResolutionFor),
+     *                     widened if a road distance exceeds its range
+     * @return Distance matrix
      */
-    std::vector<std::vector<double>> calculateRoadDistanceMatrix(
+    DistanceMatrix calculateRoadDistanceMatrix(
         const std::vector<Point>& people, 
-        const std::vector<Point>& testCenters) {
+        const std::vector<Point>& testCenters,
+        MatrixPrecision precision = MatrixPrecision::Float32,
+        MatrixLayout layout = MatrixLayout::PersonMajor,
+        double resolutionKm = 0.01) {
         
-        std::vector<std::vector<double>> matrix(people.size(), std::vector<double>(testCenters.size()));
-        int totalPairs = people.size() * testCenters.size();
-        int processedCount = 0;
+        DistanceMatrix matrix(people.size(), testCenters.size(), precision, layout, resolutionKm);
+        fillRoadDistanceMatrix(people, testCenters, matrix);
+        return matrix;
+    }
+
+    /**
+     * Fill a preallocated (heap or file-backed) matrix in tiles of person rows.
+     * Each finished tile of a file-backed person-major matrix is written back
+     * and dropped from memory, so resident size stays at about one tile.
+     * With a checkpoint file set, every finished tile is also saved durably
+     * and a rerun with the same inputs resumes after the last saved tile.
+     * A Fixed16 matrix is widened in place when a road distance exceeds its
+     * range, so an underestimated detour never aborts the fill.
+     * @param people Vector of people points
+     * @param testCenters Vector of test center points
+     * @param matrix Matrix sized people x testCenters
+     */
+    void fillRoadDistanceMatrix(
+        const std::vector<Point>& people, 
+        const std::vector<Point>& testCenters,
+        DistanceMatrix& matrix) {
+        
+        long long totalPairs = static_cast<long long>(people.size()) * testCenters.size();
+        long long processedCount = 0;
+        bool personRows = matrix.getLayout() == MatrixLayout::PersonMajor;
         
         std::cout << "Calculating road distances for " << totalPairs << " pairs..." << std::endl;
+        matrix.adviseSequential();
         
-        for (size_t i = 0; i < people.size(); i++) {
-            for (size_t j = 0; j < testCenters.size(); j++) {
-                matrix[i][j] = calculateRoadDistance(people[i], testCenters[j]);
-                processedCount++;
-                
-                // Update progress every 10 calculations
-                if (processedCount % 10 == 0) {
-                    int progress = (processedCount * 100) / totalPairs;
-                    std::string message = "Processed " + std::to_string(processedCount) + 
-                                        "/" + std::to_string(totalPairs) + " distances (" + 
-                                        std::to_string(progress) + "%)";
-                    
-                    if (progressCallback) {
-                        progressCallback(processedCount, totalPairs, message);
-                    }
-                    
-                    std::cout << message << std::endl;
-                }
-                
-                // Small delay to be respectful to the API
-                if (processedCount % 25 == 0) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::unique_ptr<MatrixCheckpoint> checkpoint;
+        std::vector<bool> completedTiles;
+        if (!checkpointFile.empty()) {
+            checkpoint = std::make_unique<MatrixCheckpoint>(checkpointFile, people, testCenters, tileRows);
+            completedTiles = checkpoint->restore(matrix);
+        }
+        
+        for (size_t tileStart = 0; tileStart < people.size(); tileStart += tileRows) {
+            size_t tileEnd = std::min(tileStart + tileRows, people.size());
+            size_t tileIndex = tileStart / tileRows;
+            
+            if (checkpoint && completedTiles[tileIndex]) {
+                processedCount += static_cast<long long>(tileEnd - tileStart) * testCenters.size();
+            } else {
+                computeTile(people, testCenters, matrix, tileStart, tileEnd, processedCount, totalPairs);
+                if (checkpoint) {
+                    checkpoint->saveTile(tileIndex, matrix);
                 }
             }
+            
+            if (personRows) {
+                matrix.padRows(tileStart, tileEnd);
+                matrix.flushRows(tileStart, tileEnd);
+                matrix.releaseRows(tileStart, tileEnd);
+            }
+        }
+        
+        if (!personRows) {
+            matrix.padRows(0, matrix.getStorageRowCount());
+        }
+        
+        if (checkpoint) {
+            checkpoint->complete();
         }
         
         std::cout << "Road distance matrix calculation completed!" << std::endl;
-        return matrix;
+    }
+
+    /**
+     * Set number of person rows computed per tile
+     * @param rows Rows per tile
+     */
+    void setTileRows(size_t rows) {
+        tileRows = std::max<size_t>(rows, 1);
+    }
+
+    /**
+     * Checkpoint completed tiles of matrix computations to a file. The file is
+     * validated against a hash of the inputs on resume and removed once the
+     * matrix is complete. An empty path disables checkpointing.
+     * @param path Checkpoint file
+     */
+    void setCheckpointFile(const std::string& path) {
+        checkpointFile = path;
+    }
+
+    const std::string& getCheckpointFile() const {
+        return checkpointFile;
     }
 
     /**
@@ -196,10 +215,80 @@ public:
     }
 
     /**
-     * Clear cache
+     * Register the local road graph as an additional distance backend.
+     * The graph is referenced, not copied, and must outlive the service.
+     * @param graph Road graph with edge weights in meters
+     * @param vertexLocations Coordinates of each graph vertex
+     * @param priorLatencyMs Expected latency per query before measurements exist
+     */
+    void setRoadGraph(const Graph& graph, const std::unordered_map<std::string, Point>& vertexLocations,
+                      double priorLatencyMs = 5.0) {
+        queryPlanner.addBackend(std::make_shared<GraphBackend>(graph, vertexLocations), priorLatencyMs, 0.05);
+    }
+
+    /**
+     * Get the query planner choosing backends for each pair
+     * @return Query planner
+     */
+    DistanceQueryPlanner& getQueryPlanner() {
+        return queryPlanner;
+    }
+
+    /**
+     * Replace the HTTP transport used for OSRM requests, e.g. with a
+     * RecordingTransport or ReplayTransport for reproducible offline benchmarks
+     * @param transport HTTP transport
+     */
+    void setHttpTransport(std::shared_ptr<HttpTransport> transport) {
+        osrmBackend->setTransport(transport);
+    }
+
+    /**
+     * Get the HTTP transport used for OSRM requests
+     * @return HTTP transport
+     */
+    std::shared_ptr<HttpTransport> getHttpTransport() const {
+        return osrmBackend->getTransport();
+    }
+
+    /**
+     * Get the coordinate snapping policy applied before cache lookup and routing
+     * @return Coordinate snapper (reports the induced distance error)
+     */
+    CoordinateSnapper& getCoordinateSnapper() {
+        return coordinateSnapper;
+    }
+
+    /**
+     * Get the grid A* algorithm used by the A* backend
+     * @return A* algorithm
+     */
+    AStarAlgorithm& getAStarAlgorithm() {
+        return aStarBackend->getAStarAlgorithm();
+    }
+
+    /**
+     * Back the distance cache with a persistent memory-mapped store that is
+     * reused across runs
+     * @param path Store file
+     */
+    void setPersistentCacheFile(const std::string& path) {
+        cache->openPersistentStore(path);
+    }
+
+    /**
+     * Get the tiered distance cache shared by all backends
+     * @return Distance cache
+     */
+    std::shared_ptr<DistanceCache> getDistanceCache() const {
+        return cache;
+    }
+
+    /**
+     * Clear the in-process cache tier
      */
     void clearCache() {
-        cache.clear();
+        cache->clear();
     }
 
     /**
@@ -207,100 +296,54 @@ public:
      * @return Cache statistics
      */
     std::map<std::string, int> getCacheStats() const {
-        std::map<std::string, int> stats;
-        stats["size"] = cache.size();
-        stats["timeout"] = cacheTimeout;
+        std::map<std::string, int> stats = cache->getCacheStats();
+        stats["size"] = stats["l1_size"];
+        stats["hits"] = stats["l1_hits"] + stats["l2_hits"];
+        stats["timeout"] = cache->getTimeout();
         stats["batch_size"] = batchSize;
+        stats["tile_rows"] = static_cast<int>(tileRows);
         return stats;
     }
 
 private:
     /**
-     * Calculate distance using OSRM API
-     * @param point1 First point
-     * @param point2 Second point
-     * @return Distance in kilometers
+     * Compute one tile of person rows
+     * @param people Vector of people points
+     * @param testCenters Vector of test center points
+     * @param matrix Matrix receiving the distances
+     * @param tileStart First person row of the tile
+     * @param tileEnd One past the last person row of the tile
+     * @param processedCount Pairs processed so far (updated)
+     * @param totalPairs Total pairs in the matrix
      */
-    double calculateOSRMDistance(const Point& point1, const Point& point2) {
-        if (!curl) {
-            throw std::runtime_error("CURL not initialized");
-        }
-        
-        // Build OSRM URL
-        std::ostringstream urlStream;
-        urlStream << baseUrl << "/" 
-                  << point1.longitude << "," << point1.latitude << ";"
-                  << point2.longitude << "," << point2.latitude 
-                  << "?overview=false";
-        
-        std::string url = urlStream.str();
-        std::string response;
-        
-        // Set up CURL request
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
-        
-        if (res != CURLE_OK) {
-            throw std::runtime_error("CURL error: " + std::string(curl_easy_strerror(res)));
-        }
-        
-        // Parse JSON response (simplified)
-        return parseOSRMResponse(response);
-    }
+    void computeTile(const std::vector<Point>& people, const std::vector<Point>& testCenters,
+                     DistanceMatrix& matrix, size_t tileStart, size_t tileEnd,
+                     long long& processedCount, long long totalPairs) {
+        for (size_t i = tileStart; i < tileEnd; i++) {
+            for (size_t j = 0; j < testCenters.size(); j++) {
+                matrix.setWidening(i, j, calculateRoadDistance(people[i], testCenters[j]));
+                processedCount++;
 
-    /**
-     * Parse OSRM JSON response to extract distance
-     * @param response JSON response string
-     * @return Distance in kilometers
-     */
-    double parseOSRMResponse(const std::string& response) {
-        // Simple JSON parsing for distance extraction
-        // Look for "distance": value in the response
-        size_t distancePos = response.find("\"distance\":");
-        if (distancePos == std::string::npos) {
-            throw std::runtime_error("Distance not found in OSRM response");
-        }
-        
-        // Find the distance value
-        size_t valueStart = response.find_first_of("0123456789", distancePos);
-        size_t valueEnd = response.find_first_not_of("0123456789.", valueStart);
-        
-        if (valueStart == std::string::npos) {
-            throw std::runtime_error("Invalid distance value in OSRM response");
-        }
-        
-        std::string distanceStr = response.substr(valueStart, valueEnd - valueStart);
-        double distanceMeters = std::stod(distanceStr);
-        
-        return distanceMeters / 1000.0; // Convert meters to kilometers
-    }
+                // Update progress every 10 calculations
+                if (processedCount % 10 == 0) {
+                    int progress = static_cast<int>((processedCount * 100) / totalPairs);
+                    std::string message = "Processed " + std::to_string(processedCount) +
+                                        "/" + std::to_string(totalPairs) + " distances (" +
+                                        std::to_string(progress) + "%)";
 
-    /**
-     * Get cache key for two points
-     * @param point1 First point
-     * @param point2 Second point
-     * @return Cache key string
-     */
-    std::string getCacheKey(const Point& point1, const Point& point2) const {
-        // Create consistent key regardless of order
-        std::ostringstream keyStream;
-        
-        if (point1.latitude < point2.latitude || 
-            (point1.latitude == point2.latitude && point1.longitude < point2.longitude)) {
-            keyStream << std::fixed << std::setprecision(6) 
-                      << point1.latitude << "," << point1.longitude << "|"
-                      << point2.latitude << "," << point2.longitude;
-        } else {
-            keyStream << std::fixed << std::setprecision(6) 
-                      << point2.latitude << "," << point2.longitude << "|"
-                      << point1.latitude << "," << point1.longitude;
+                    if (progressCallback) {
+                        progressCallback(static_cast<int>(processedCount), static_cast<int>(totalPairs), message);
+                    }
+
+                    std::cout << message << std::endl;
+                }
+
+                // Small delay to be respectful to the API
+                if (processedCount % 25 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
         }
-        
-        return keyStream.str();
     }
 };
 
@@ -0,0 +1,204 @@
+#ifndef SCENARIO_RUNNER_H
+#define SCENARIO_RUNNER_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include "AssignmentAlgorithm.h"
+
+/**
+ * One assignment configuration to try against a shared distance matrix
+ */
+struct AssignmentScenario {
+    std::string name;
+    int capacityPerCenter;
+    std::vector<int> centerCapacities; // Per-center override (empty = capacityPerCenter everywhere)
+    std::vector<std::string> priorityOrder; // Categories served first to last (empty = pwd, female, male)
+    AssignmentEngine engine;
+    double localSearchBudget; // Seconds, 0 = no improvement phase
+
+    AssignmentScenario(const std::string& n = "", int capacity = 50, AssignmentEngine e = AssignmentEngine::Greedy)
+        : name(n), capacityPerCenter(capacity), engine(e), localSearchBudget(0.0) {}
+};
+
+struct ScenarioResult {
+    std::string name;
+    AssignmentStats stats;
+    int unassigned;
+    double totalDistance;
+    int fullCenters;
+    double elapsedMs;
+    std::vector<int> assignedCenter; // Per person, -1 if unassigned
+
+    ScenarioResult() : unassigned(0), totalDistance(0), fullCenters(0), elapsedMs(0) {}
+};
+
+/**
+ * Runs many assignment scenarios on the same people and centers against
+ * one distance matrix, computed or loaded once by the caller (see
+ * AssignmentAlgorithm::prepareDistanceMatrix and DistanceMatrix::openMapped).
+ *
+ * The matrix is only read, so scenarios run in parallel, each on its own
+ * AssignmentAlgorithm; a scenario's own solver and local search use one
+ * thread when scenarios already run side by side.
+ */
+class ScenarioRunner {
+private:
+    const std::vector<Point>& people;
+    const std::vector<Point>& testCenters;
+    const DistanceMatrix& matrix;
+    int threadCount;
+
+public:
+    /**
+     * @param p People (matrix rows; must outlive the runner)
+     * @param centers Test centers (matrix columns; must outlive the runner)
+     * @param distances Shared distance matrix (must outlive the runner)
+     */
+    ScenarioRunner(const std::vector<Point>& p, const std::vector<Point>& centers, const DistanceMatrix& distances)
+        : people(p)
+        , testCenters(centers)
+        , matrix(distances)
+        , threadCount(std::max(1u, std::thread::hardware_concurrency())) {
+
+        if (matrix.getPersonCount() != people.size() || matrix.getCenterCount() != testCenters.size()) {
+            throw std::runtime_error("Scenario matrix does not match the people and test centers");
+        }
+    }
+
+    /**
+     * Set number of scenarios run at once
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void setThreadCount(int threads) {
+        threadCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Run every scenario
+     * @param scenarios Scenarios
+     * @return One result per scenario, in input order
+     */
+    std::vector<ScenarioResult> run(const std::vector<AssignmentScenario>& scenarios) const {
+        // Reject bad scenarios before any worker starts
+        for (const auto& scenario : scenarios) {
+            if (!scenario.centerCapacities.empty() && scenario.centerCapacities.size() != testCenters.size()) {
+                throw std::runtime_error("Scenario " + scenario.name + " has " +
+                                         std::to_string(scenario.centerCapacities.size()) +
+                                         " center capacities, expected " + std::to_string(testCenters.size()));
+            }
+            AssignmentAlgorithm probe;
+            probe.setPriorityOrder(scenario.priorityOrder); // Throws on too many categories
+        }
+
+        std::vector<ScenarioResult> results(scenarios.size());
+        int threads = std::min<int>(threadCount, static_cast<int>(scenarios.size()));
+
+        std::atomic<size_t> nextScenario(0);
+        auto worker = [&]() {
+            for (size_t s = nextScenario++; s < scenarios.size(); s = nextScenario++) {
+                results[s] = runScenario(scenarios[s], threads > 1 ? 1 : 0);
+            }
+        };
+
+        if (threads <= 1) {
+            worker();
+            return results;
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back(worker);
+        }
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+        return results;
+    }
+
+    /**
+     * Format results as a comparison table; the total distance is also
+     * shown relative to the first scenario
+     * @param results Scenario results
+     * @return Table text
+     */
+    static std::string formatTable(const std::vector<ScenarioResult>& results) {
+        size_t nameWidth = 8;
+        for (const auto& result : results) {
+            nameWidth = std::max(nameWidth, result.name.size());
+        }
+
+        std::ostringstream table;
+        table << std::left << std::setw(nameWidth) << "Scenario" << std::right
+              << std::setw(9) << "Assigned" << std::setw(7) << "PWD" << std::setw(8) << "Female"
+              << std::setw(8) << "Male" << std::setw(8) << "Unasgn" << std::setw(12) << "Total km"
+              << std::setw(9) << "vs 1st" << std::setw(9) << "Avg km" << std::setw(9) << "P90 km" << std::setw(9) << "Max km"
+              << std::setw(7) << "Full" << std::setw(10) << "ms" << "\n";
+
+        double baseline = results.empty() ? 0.0 : results.front().totalDistance;
+        table << std::fixed;
+        for (const auto& result : results) {
+            table << std::left << std::setw(nameWidth) << result.name << std::right
+                  << std::setw(9) << result.stats.totalAssigned << std::setw(7) << result.stats.pwdAssigned
+                  << std::setw(8) << result.stats.femaleAssigned << std::setw(8) << result.stats.maleAssigned
+                  << std::setw(8) << result.unassigned << std::setw(12) << std::setprecision(1) << result.totalDistance;
+            if (baseline > 0) {
+                table << std::setw(8) << std::showpos << std::setprecision(1)
+                      << 100.0 * (result.totalDistance - baseline) / baseline << "%" << std::noshowpos;
+            } else {
+                table << std::setw(9) << "-";
+            }
+            table << std::setw(9) << std::setprecision(2) << result.stats.averageDistance
+                  << std::setw(9) << std::setprecision(2) << result.stats.p90Distance
+                  << std::setw(9) << std::setprecision(2) << (result.stats.totalAssigned > 0 ? result.stats.maxDistance : 0.0)
+                  << std::setw(7) << result.fullCenters << std::setw(10) << std::setprecision(1) << result.elapsedMs << "\n";
+        }
+        return table.str();
+    }
+
+private:
+    ScenarioResult runScenario(const AssignmentScenario& scenario, int solverThreads) const {
+        auto start = std::chrono::steady_clock::now();
+
+        AssignmentAlgorithm algorithm;
+        algorithm.setVerbose(false); // Scenarios run side by side; results go to formatTable
+        algorithm.setAssignmentEngine(scenario.engine);
+        algorithm.setAuctionThreads(solverThreads);
+        algorithm.setPriorityOrder(scenario.priorityOrder);
+        algorithm.setLocalSearch(scenario.localSearchBudget, LocalSearchObjective::TotalDistance, solverThreads);
+
+        std::vector<int> capacities = scenario.centerCapacities.empty() ?
+            std::vector<int>(testCenters.size(), scenario.capacityPerCenter) : scenario.centerCapacities;
+        std::vector<std::vector<int>> slots(capacities.size());
+        for (size_t j = 0; j < capacities.size(); j++) {
+            slots[j].push_back(capacities[j]);
+        }
+
+        std::vector<AssignmentResult> assigned = algorithm.assignPeopleWithMatrix(
+            people, testCenters, SlotSchedule(slots), matrix);
+
+        ScenarioResult result;
+        result.name = scenario.name;
+        result.stats = algorithm.getAssignmentStats();
+        result.unassigned = static_cast<int>(people.size() - assigned.size());
+        result.assignedCenter.assign(people.size(), -1);
+        std::vector<int> load(testCenters.size(), 0);
+        for (const auto& assignment : assigned) {
+            result.assignedCenter[assignment.personIndex] = assignment.centerIndex;
+            result.totalDistance += assignment.distance;
+            load[assignment.centerIndex]++;
+        }
+        for (size_t j = 0; j < load.size(); j++) {
+            if (capacities[j] > 0 && load[j] >= capacities[j]) result.fullCenters++;
+        }
+        result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+};
+
+#endif // SCENARIO_RUNNER_H
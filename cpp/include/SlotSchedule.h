@@ -0,0 +1,171 @@
+#ifndef SLOT_SCHEDULE_H
+#define SLOT_SCHEDULE_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Per-center time slots (sessions, days) with their own capacities.
+ *
+ * Travel distance does not depend on the slot, so the assignment engines
+ * only ever see one capacity per center: the sum of its slots. Slots are
+ * handed out afterwards, center by center, so the distance matrix stays
+ * P x C however many slots there are. Slots are stored flat (CSR style)
+ * with one cursor per center pointing at its earliest slot with room.
+ */
+class SlotSchedule {
+private:
+    std::vector<int> slotOffset; // Center c owns slots [slotOffset[c], slotOffset[c + 1])
+    std::vector<int> slotCapacity;
+    std::vector<int> slotUsed;
+    std::vector<int> firstOpen; // Per center, earliest slot that may have room
+
+public:
+    SlotSchedule() : slotOffset(1, 0) {}
+
+    /**
+     * Same slots for every center
+     * @param centers Number of test centers
+     * @param slots Slots per center
+     * @param capacityPerSlot Capacity of every slot
+     */
+    SlotSchedule(size_t centers, int slots, int capacityPerSlot) : slotOffset(1, 0) {
+        slots = std::max(slots, 1);
+        for (size_t c = 0; c < centers; c++) {
+            slotCapacity.insert(slotCapacity.end(), slots, std::max(capacityPerSlot, 0));
+            slotOffset.push_back(static_cast<int>(slotCapacity.size()));
+        }
+        reset();
+    }
+
+    /**
+     * Heterogeneous slots
+     * @param capacities capacities[c][s] = capacity of slot s at center c
+     */
+    explicit SlotSchedule(const std::vector<std::vector<int>>& capacities) : slotOffset(1, 0) {
+        for (size_t c = 0; c < capacities.size(); c++) {
+            if (capacities[c].empty()) {
+                throw std::runtime_error("Test center " + std::to_string(c) + " has no slots");
+            }
+            for (int capacity : capacities[c]) {
+                slotCapacity.push_back(std::max(capacity, 0));
+            }
+            slotOffset.push_back(static_cast<int>(slotCapacity.size()));
+        }
+        reset();
+    }
+
+    /**
+     * Empty every slot
+     */
+    void reset() {
+        slotUsed.assign(slotCapacity.size(), 0);
+        firstOpen.assign(slotOffset.begin(), slotOffset.end() - 1);
+    }
+
+    size_t getCenterCount() const {
+        return slotOffset.size() - 1;
+    }
+
+    int getSlotCount(int centerIndex) const {
+        return slotOffset[centerIndex + 1] - slotOffset[centerIndex];
+    }
+
+    int getTotalSlotCount() const {
+        return static_cast<int>(slotCapacity.size());
+    }
+
+    int getSlotCapacity(int centerIndex, int slot) const {
+        return slotCapacity[slotOffset[centerIndex] + slot];
+    }
+
+    /**
+     * Set the capacity of one slot (people already in it stay)
+     */
+    void setSlotCapacity(int centerIndex, int slot, int capacity) {
+        int index = slotOffset[centerIndex] + slot;
+        slotCapacity[index] = std::max(capacity, 0);
+        if (slotUsed[index] < slotCapacity[index]) {
+            firstOpen[centerIndex] = std::min(firstOpen[centerIndex], index);
+        }
+    }
+
+    /**
+     * Get the capacity the assignment engines see for a center
+     * @param centerIndex Test center index
+     * @return Sum of the center's slot capacities
+     */
+    int getCenterCapacity(int centerIndex) const {
+        int total = 0;
+        for (int s = slotOffset[centerIndex]; s < slotOffset[centerIndex + 1]; s++) {
+            total += slotCapacity[s];
+        }
+        return total;
+    }
+
+    /**
+     * Get the summed capacity of every center
+     */
+    std::vector<int> getCenterCapacities() const {
+        std::vector<int> capacities(getCenterCount());
+        for (size_t c = 0; c < capacities.size(); c++) {
+            capacities[c] = getCenterCapacity(c);
+        }
+        return capacities;
+    }
+
+    /**
+     * Take a unit of the earliest slot with room at a center
+     * @param centerIndex Test center index
+     * @return Slot within the center, or -1 if every slot is full
+     */
+    int takeSlot(int centerIndex) {
+        int& index = firstOpen[centerIndex];
+        while (index < slotOffset[centerIndex + 1] && slotUsed[index] >= slotCapacity[index]) {
+            index++;
+        }
+        if (index == slotOffset[centerIndex + 1]) return -1;
+        slotUsed[index]++;
+        return index - slotOffset[centerIndex];
+    }
+
+    /**
+     * Give a unit of a slot back
+     * @param centerIndex Test center index
+     * @param slot Slot within the center
+     */
+    void releaseSlot(int centerIndex, int slot) {
+        int index = slotOffset[centerIndex] + slot;
+        slotUsed[index]--;
+        firstOpen[centerIndex] = std::min(firstOpen[centerIndex], index);
+    }
+
+    int getSlotUsed(int centerIndex, int slot) const {
+        return slotUsed[slotOffset[centerIndex] + slot];
+    }
+
+    /**
+     * Get slot occupancy statistics
+     * @return Slot count, capacity, used units and fully booked slots
+     */
+    std::map<std::string, long long> getSlotStats() const {
+        std::map<std::string, long long> stats;
+        long long capacity = 0, used = 0, full = 0;
+        for (size_t s = 0; s < slotCapacity.size(); s++) {
+            capacity += slotCapacity[s];
+            used += slotUsed[s];
+            if (slotCapacity[s] > 0 && slotUsed[s] >= slotCapacity[s]) full++;
+        }
+        stats["centers"] = getCenterCount();
+        stats["slots"] = slotCapacity.size();
+        stats["capacity"] = capacity;
+        stats["used"] = used;
+        stats["full_slots"] = full;
+        return stats;
+    }
+};
+
+#endif // SLOT_SCHEDULE_H
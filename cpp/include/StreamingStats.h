@@ -0,0 +1,307 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+/**
+ * One-pass count, sum, mean, variance (Welford) and min/max. Two instances
+ * merge exactly (Chan et al.), so partial results from threads or chunks
+ * can be combined in any order.
+ */
+class RunningStats {
+private:
+    long long count;
+    double sum;
+    double mean; // Welford running mean, used for the M2 update
+    double m2;   // Sum of squared deviations from the mean
+    double minimum;
+    double maximum;
+
+public:
+    RunningStats()
+        : count(0), sum(0.0), mean(0.0), m2(0.0)
+        , minimum(std::numeric_limits<double>::max())
+        , maximum(std::numeric_limits<double>::lowest()) {}
+
+    void add(double value) {
+        count++;
+        sum += value;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+    }
+
+    void merge(const RunningStats& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        long long total = count + other.count;
+        double delta = other.mean - mean;
+        m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+        mean += delta * other.count / total;
+        count = total;
+        sum += other.sum;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+    }
+
+    long long getCount() const { return count; }
+    double getSum() const { return sum; }
+    double getMean() const { return count > 0 ? sum / count : 0.0; }
+    double getVariance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double getStdDev() const { return std::sqrt(getVariance()); }
+    double getMin() const { return minimum; } // max() when empty
+    double getMax() const { return count > 0 ? maximum : 0.0; }
+};
+
+/**
+ * RunningStats plus a log-bucketed histogram for quantiles (HDR / DDSketch
+ * style). Bucket i holds values in (gamma^(i-1), gamma^i] with gamma =
+ * (1 + a) / (1 - a), so any quantile is reported within relative error a
+ * (1% by default) using a few KB however many values are added. Values at
+ * or below MIN_TRACKED share one bucket reported as 0, values above
+ * MAX_TRACKED one reported as the maximum. Non-finite values (unreachable
+ * pairs) are only counted, never added to the statistics.
+ * Sketches with the same accuracy merge by adding bucket counts.
+ */
+class DistanceSketch {
+private:
+    static constexpr double MIN_TRACKED = 1e-6; // km (1 mm)
+    static constexpr double MAX_TRACKED = 1e9;  // Larger values share one top bucket reported as the max
+
+    double accuracy;
+    double gamma;
+    double logGamma;
+    int indexOffset; // Bucket index of MIN_TRACKED, so stored indices start at 0
+    size_t bucketLimit; // Buckets needed up to MAX_TRACKED
+    RunningStats running;
+    long long zeroCount;
+    long long overflowCount; // Finite values above MAX_TRACKED
+    long long nonFiniteCount;
+    std::vector<uint64_t> buckets; // Grown on demand, at most bucketLimit
+
+public:
+    /**
+     * @param relativeAccuracy Relative error bound of reported quantiles
+     */
+    explicit DistanceSketch(double relativeAccuracy = 0.01)
+        : accuracy(std::min(std::max(relativeAccuracy, 1e-4), 0.5))
+        , gamma((1 + accuracy) / (1 - accuracy))
+        , logGamma(std::log(gamma))
+        , indexOffset(static_cast<int>(std::ceil(std::log(MIN_TRACKED) / logGamma)))
+        , bucketLimit(static_cast<size_t>(std::ceil(std::log(MAX_TRACKED) / logGamma) - indexOffset) + 1)
+        , zeroCount(0)
+        , overflowCount(0)
+        , nonFiniteCount(0) {}
+
+    void add(double value) {
+        if (!std::isfinite(value)) {
+            nonFiniteCount++;
+            return;
+        }
+        running.add(value);
+        if (value <= MIN_TRACKED) {
+            zeroCount++;
+            return;
+        }
+        if (value > MAX_TRACKED) {
+            overflowCount++;
+            return;
+        }
+        size_t index = static_cast<size_t>(static_cast<int>(std::ceil(std::log(value) / logGamma)) - indexOffset);
+        if (index >= bucketLimit) {
+            overflowCount++;
+            return;
+        }
+        if (index >= buckets.size()) {
+            buckets.resize(index + 1, 0);
+        }
+        buckets[index]++;
+    }
+
+    void merge(const DistanceSketch& other) {
+        if (other.gamma != gamma) {
+            throw std::runtime_error("Cannot merge distance sketches of different accuracy");
+        }
+        running.merge(other.running);
+        zeroCount += other.zeroCount;
+        overflowCount += other.overflowCount;
+        nonFiniteCount += other.nonFiniteCount;
+        if (other.buckets.size() > buckets.size()) {
+            buckets.resize(other.buckets.size(), 0);
+        }
+        for (size_t i = 0; i < other.buckets.size(); i++) {
+            buckets[i] += other.buckets[i];
+        }
+    }
+
+    /**
+     * Estimate a quantile
+     * @param q Quantile in [0, 1] (0.5 = median)
+     * @return Value within the relative accuracy of the true quantile, clamped to [min, max]; 0 when empty
+     */
+    double quantile(double q) const {
+        long long count = running.getCount();
+        if (count == 0) return 0.0;
+        q = std::min(std::max(q, 0.0), 1.0);
+        double rank = q * (count - 1);
+
+        double seen = static_cast<double>(zeroCount);
+        if (rank < seen) return std::max(running.getMin(), 0.0);
+        for (size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if (rank < seen) {
+                double estimate = 2.0 * std::exp((static_cast<int>(i) + indexOffset) * logGamma) / (gamma + 1.0);
+                return std::min(std::max(estimate, running.getMin()), running.getMax());
+            }
+        }
+        return running.getMax();
+    }
+
+    const RunningStats& getRunning() const { return running; }
+    long long getCount() const { return running.getCount() + nonFiniteCount; } // Every value added
+    long long getNonFiniteCount() const { return nonFiniteCount; }
+    double getAccuracy() const { return accuracy; }
+};
+
+/**
+ * Streaming summary of an assignment: a distance sketch overall and per
+ * category, and distance stats plus load per center, from which the
+ * utilization (load / capacity) distribution over centers is built.
+ * Partial distributions over the same centers merge, so threads or chunks
+ * can each fill one and combine them.
+ */
+class AssignmentDistribution {
+private:
+    DistanceSketch overall;
+    std::map<std::string, DistanceSketch> byCategory;
+    std::vector<RunningStats> byCenter; // Finite distances only
+    std::vector<long long> centerLoad;
+    std::vector<int> centerCapacity;
+
+public:
+    AssignmentDistribution() {}
+
+    /**
+     * @param capacities Initial capacity per center (utilization denominators)
+     */
+    explicit AssignmentDistribution(const std::vector<int>& capacities)
+        : byCenter(capacities.size()), centerLoad(capacities.size(), 0), centerCapacity(capacities) {}
+
+    /**
+     * Add one assigned person
+     * @param centerIndex Assigned center
+     * @param distance Travel distance
+     * @param category Person category
+     */
+    void add(int centerIndex, double distance, const std::string& category) {
+        overall.add(distance);
+        byCategory[category].add(distance);
+        if (centerIndex >= 0 && static_cast<size_t>(centerIndex) < byCenter.size()) {
+            centerLoad[centerIndex]++;
+            if (std::isfinite(distance)) {
+                byCenter[centerIndex].add(distance);
+            }
+        }
+    }
+
+    void merge(const AssignmentDistribution& other) {
+        if (other.byCenter.size() != byCenter.size()) {
+            throw std::runtime_error("Cannot merge assignment distributions over different centers");
+        }
+        overall.merge(other.overall);
+        for (const auto& entry : other.byCategory) {
+            byCategory[entry.first].merge(entry.second);
+        }
+        for (size_t j = 0; j < byCenter.size(); j++) {
+            byCenter[j].merge(other.byCenter[j]);
+            centerLoad[j] += other.centerLoad[j];
+        }
+    }
+
+    const DistanceSketch& getOverall() const {
+        return overall;
+    }
+
+    const std::map<std::string, DistanceSketch>& getByCategory() const {
+        return byCategory;
+    }
+
+    /**
+     * Get distance stats of the people assigned to a center
+     */
+    const RunningStats& getCenter(int centerIndex) const {
+        return byCenter[centerIndex];
+    }
+
+    long long getCenterLoad(int centerIndex) const {
+        return centerLoad[centerIndex];
+    }
+
+    size_t getCenterCount() const {
+        return byCenter.size();
+    }
+
+    /**
+     * Get load / capacity of a center
+     * @return Utilization in [0, 1] (0 for a center without capacity)
+     */
+    double getUtilization(int centerIndex) const {
+        return centerCapacity[centerIndex] > 0 ?
+            static_cast<double>(centerLoad[centerIndex]) / centerCapacity[centerIndex] : 0.0;
+    }
+
+    /**
+     * Build the distribution of utilization over centers with capacity
+     * @return Sketch of per-center utilization
+     */
+    DistanceSketch getUtilizationSketch() const {
+        DistanceSketch sketch;
+        for (size_t j = 0; j < byCenter.size(); j++) {
+            if (centerCapacity[j] > 0) {
+                sketch.add(getUtilization(j));
+            }
+        }
+        return sketch;
+    }
+
+    /**
+     * Flatten into named values (count, mean, stddev, min, max, p50, p90, p99,
+     * nonfinite) per scope: "all", "category.<name>" and "utilization"
+     * @return Statistics by "<scope>.<measure>"
+     */
+    std::map<std::string, double> getSummary() const {
+        std::map<std::string, double> summary;
+        auto describe = [&summary](const std::string& scope, const DistanceSketch& sketch) {
+            const RunningStats& running = sketch.getRunning();
+            summary[scope + ".count"] = sketch.getCount();
+            summary[scope + ".nonfinite"] = sketch.getNonFiniteCount();
+            summary[scope + ".mean"] = running.getMean();
+            summary[scope + ".stddev"] = running.getStdDev();
+            summary[scope + ".min"] = running.getCount() > 0 ? running.getMin() : 0.0;
+            summary[scope + ".max"] = running.getMax();
+            summary[scope + ".p50"] = sketch.quantile(0.50);
+            summary[scope + ".p90"] = sketch.quantile(0.90);
+            summary[scope + ".p99"] = sketch.quantile(0.99);
+        };
+        describe("all", overall);
+        for (const auto& entry : byCategory) {
+            describe("category." + entry.first, entry.second);
+        }
+        describe("utilization", getUtilizationSketch());
+        return summary;
+    }
+};
+
+#endif // STREAMING_STATS_H
@@ -0,0 +1,145 @@
+#ifndef TIERED_ASSIGNMENT_BASE_H
+#define TIERED_ASSIGNMENT_BASE_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include "CandidateDistanceMatrix.h"
+
+/**
+ * State and steps shared by the optimal per-tier solvers
+ * (MinCostFlowAssignment, AuctionAssignment): remaining capacity and
+ * per-person results, integer arc costs, candidate extension for people a
+ * tier left unassigned, and freezing a finished tier.
+ *
+ * Candidates with a non-finite distance (unreachable pairs) never become
+ * arcs; finite distances beyond MAX_ARC_COST are clamped to it.
+ */
+class TieredAssignmentBase {
+public:
+    using CandidateList = std::function<const std::vector<DistanceCandidate>&(int)>;
+    using CandidateExtender = std::function<bool(int)>;
+
+protected:
+    static constexpr int64_t MAX_ARC_COST = 40000000; // 40,000 km in meters
+
+    CandidateList candidatesOf;
+    CandidateExtender extendCandidates;
+
+    std::vector<int> remainingCapacity;   // Free units per center
+    std::vector<int> assignedCenter;      // Per person, -1 if unassigned
+    std::vector<double> assignedDistance; // Per person, km
+
+    long long extensionRounds;
+
+    /**
+     * @param people Number of people
+     * @param capacities Remaining capacity of each center
+     * @param candidates Candidate centers of a person (distances in km); lists
+     *                   are read one at a time, so a returned list need only
+     *                   stay valid until the next call
+     * @param extender Adds more candidates for a person, false once exhausted (optional)
+     */
+    TieredAssignmentBase(size_t people, const std::vector<int>& capacities,
+                         CandidateList candidates, CandidateExtender extender)
+        : candidatesOf(candidates)
+        , extendCandidates(extender)
+        , remainingCapacity(capacities)
+        , assignedCenter(people, -1)
+        , assignedDistance(people, 0.0)
+        , extensionRounds(0) {
+
+        for (int& capacity : remainingCapacity) {
+            capacity = std::max(capacity, 0);
+        }
+    }
+
+    /**
+     * Check whether a candidate can become an arc
+     * @return False for unreachable (non-finite) distances
+     */
+    static bool isReachable(const DistanceCandidate& candidate) {
+        return std::isfinite(candidate.distance);
+    }
+
+    /**
+     * Convert a reachable distance to integer meters, clamped to MAX_ARC_COST
+     */
+    static int64_t toMeters(double distanceKm) {
+        if (!std::isfinite(distanceKm) || distanceKm * 1000.0 >= MAX_ARC_COST) return MAX_ARC_COST;
+        return std::max<int64_t>(std::llround(distanceKm * 1000.0), 0);
+    }
+
+    /**
+     * Extend the candidate lists of the tier's unassigned people. Each round
+     * extends twice as far as the previous one, so a tier is re-solved only
+     * a logarithmic number of times.
+     * @param tierPeople Person indices of the tier
+     * @param unassigned Whether the tier's i-th person is unassigned
+     * @param round Extension round, advanced when anything was extended
+     * @return True if any list grew
+     */
+    bool extendUnassigned(const std::vector<int>& tierPeople, const std::function<bool(size_t)>& unassigned,
+                          int& round) {
+        if (!extendCandidates) return false;
+        bool extended = false;
+        for (size_t i = 0; i < tierPeople.size(); i++) {
+            if (!unassigned(i)) continue;
+            for (int step = 0; step < (1 << round) && extendCandidates(tierPeople[i]); step++) {
+                extended = true;
+            }
+        }
+        if (extended) {
+            extensionRounds++;
+            round = std::min(round + 1, 20);
+        }
+        return extended;
+    }
+
+    /**
+     * Freeze the tier's assignments by taking their units
+     * @param tierPeople Person indices of the tier
+     * @return Number of people of the tier assigned
+     */
+    int freezeTier(const std::vector<int>& tierPeople) {
+        int assigned = 0;
+        for (int personIndex : tierPeople) {
+            if (assignedCenter[personIndex] != -1) {
+                remainingCapacity[assignedCenter[personIndex]]--;
+                assigned++;
+            }
+        }
+        return assigned;
+    }
+
+public:
+    /**
+     * Get assigned center of a person
+     * @param personIndex Person index
+     * @return Center index or -1
+     */
+    int getAssignedCenter(int personIndex) const {
+        return assignedCenter[personIndex];
+    }
+
+    /**
+     * Get distance of a person's assignment
+     * @param personIndex Person index
+     * @return Distance in km (0 if unassigned)
+     */
+    double getAssignedDistance(int personIndex) const {
+        return assignedDistance[personIndex];
+    }
+
+    /**
+     * Get remaining capacity of each center after the frozen tiers
+     * @return Free units per center
+     */
+    const std::vector<int>& getRemainingCapacity() const {
+        return remainingCapacity;
+    }
+};
+
+#endif // TIERED_ASSIGNMENT_BASE_H
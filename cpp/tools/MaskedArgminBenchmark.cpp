@@ -0,0 +1,107 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <string>
+#include "MaskedArgmin.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --rows N             Rows per measurement (default 20000)\n"
+              << "  --full-fraction F    Fraction of centers masked as full (default 0.5)\n";
+}
+
+/**
+ * Time one kernel over a set of rows
+ * @return Nanoseconds per row
+ */
+double timeKernel(MaskedArgmin::Kernel kernel, const std::vector<float>& matrix, const std::vector<float>& penalty,
+                  size_t rows, size_t centers, long long& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rows; r++) {
+        float bestValue;
+        checksum += MaskedArgmin::findWith(kernel, matrix.data() + r * centers, penalty.data(), centers, bestValue);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / rows;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t rows = 20000;
+    double fullFraction = 0.5;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--rows" && hasValue) rows = std::stoul(argv[++i]);
+        else if (arg == "--full-fraction" && hasValue) fullFraction = std::stod(argv[++i]);
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<MaskedArgmin::Kernel> kernels;
+    for (MaskedArgmin::Kernel kernel : {MaskedArgmin::Kernel::Scalar, MaskedArgmin::Kernel::AVX2,
+                                        MaskedArgmin::Kernel::AVX512}) {
+        if (MaskedArgmin::isSupported(kernel)) kernels.push_back(kernel);
+    }
+    std::cout << "Masked argmin microbenchmark (" << rows << " rows, " << fullFraction * 100
+              << "% of centers full, dispatch picks " << MaskedArgmin::kernelName(MaskedArgmin::detect())
+              << ")" << std::endl;
+    std::cout << std::setw(8) << "centers" << std::setw(10) << "kernel" << std::setw(12) << "ns/row"
+              << std::setw(14) << "Mrows/s" << std::setw(10) << "GB/s" << std::setw(10) << "speedup" << std::endl;
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distance(0.0f, 100.0f);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    for (size_t centers : {64, 100, 500, 1000, 5000, 20000}) {
+        // Keep the working set around 64 MB so large rows still come from memory
+        size_t benchRows = std::max<size_t>(std::min(rows, (size_t(16) << 20) / centers), 16);
+        std::vector<float> matrix(benchRows * centers);
+        for (float& value : matrix) value = distance(random);
+        std::vector<float> penalty(centers);
+        for (float& value : penalty) {
+            value = unit(random) < fullFraction ? std::numeric_limits<float>::infinity() : 0.0f;
+        }
+
+        // Every kernel must agree with the scalar loop
+        for (size_t r = 0; r < benchRows; r++) {
+            float expectedValue;
+            int expected = MaskedArgmin::findScalar(matrix.data() + r * centers, penalty.data(), centers, expectedValue);
+            for (MaskedArgmin::Kernel kernel : kernels) {
+                float value;
+                if (MaskedArgmin::findWith(kernel, matrix.data() + r * centers, penalty.data(), centers, value) != expected) {
+                    std::cerr << "Mismatch: " << MaskedArgmin::kernelName(kernel) << " row " << r << std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        double scalarNs = 0;
+        for (MaskedArgmin::Kernel kernel : kernels) {
+            long long checksum = 0;
+            timeKernel(kernel, matrix, penalty, benchRows, centers, checksum); // Warm-up
+            double ns = timeKernel(kernel, matrix, penalty, benchRows, centers, checksum);
+            if (kernel == MaskedArgmin::Kernel::Scalar) scalarNs = ns;
+
+            double gigabytes = centers * 2 * sizeof(float) / ns; // Row plus penalty per row
+            std::cout << std::setw(8) << centers << std::setw(10) << MaskedArgmin::kernelName(kernel)
+                      << std::setw(12) << std::fixed << std::setprecision(1) << ns
+                      << std::setw(14) << std::setprecision(3) << 1e3 / ns
+                      << std::setw(10) << std::setprecision(2) << gigabytes
+                      << std::setw(9) << std::setprecision(2) << scalarNs / ns << "x"
+                      << (checksum == 0 ? " " : "") << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <csignal>
+#include <atomic>
+#include <thread>
+#include "MockOSRMServer.h"
+
+namespace {
+
+std::atomic<bool> stopRequested(false);
+
+void handleSignal(int) {
+    stopRequested = true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --port N             Port to listen on (default 5000, 0 = ephemeral)\n"
+              << "  --latency-ms X       Fixed latency added to every request\n"
+              << "  --jitter-ms X        Uniform random extra latency in [0, X)\n"
+              << "  --error-rate P       Fraction of requests answered with HTTP 500\n"
+              << "  --max-concurrency N  Requests beyond N in flight get HTTP 429\n"
+              << "  --graph FILE         Serve local graph distances instead of Haversine\n"
+              << "                       (lines: 'v,name,lat,lng' and 'e,from,to,meters')\n";
+}
+
+/**
+ * Load a road graph and vertex locations from a CSV file
+ * @param path Graph file
+ * @param graph Graph to fill
+ * @param locations Vertex locations to fill
+ */
+void loadGraph(const std::string& path, Graph& graph, std::unordered_map<std::string, Point>& locations) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Cannot open graph file: " + path);
+    }
+
+    std::string line;
+    while (std::getline(input, line)) {
+        std::vector<std::string> fields;
+        std::string field;
+        std::istringstream stream(line);
+        while (std::getline(stream, field, ',')) {
+            fields.push_back(field);
+        }
+
+        if (fields.size() == 4 && fields[0] == "v") {
+            graph.addVertex(fields[1]);
+            locations[fields[1]] = Point(std::stod(fields[2]), std::stod(fields[3]));
+        } else if (fields.size() == 4 && fields[0] == "e") {
+            graph.addEdge(fields[1], fields[2], std::stoi(fields[3]));
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MockServerConfig config;
+    std::string graphFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--port" && hasValue) config.port = std::stoi(argv[++i]);
+        else if (arg == "--latency-ms" && hasValue) config.latencyMs = std::stod(argv[++i]);
+        else if (arg == "--jitter-ms" && hasValue) config.latencyJitterMs = std::stod(argv[++i]);
+        else if (arg == "--error-rate" && hasValue) config.errorRate = std::stod(argv[++i]);
+        else if (arg == "--max-concurrency" && hasValue) config.maxConcurrency = std::stoi(argv[++i]);
+        else if (arg == "--graph" && hasValue) graphFile = argv[++i];
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    try {
+        Graph graph;
+        std::unordered_map<std::string, Point> locations;
+        std::shared_ptr<DistanceBackend> backend;
+
+        if (graphFile.empty()) {
+            backend = std::make_shared<HaversineBackend>();
+        } else {
+            loadGraph(graphFile, graph, locations);
+            backend = std::make_shared<GraphBackend>(graph, locations);
+        }
+
+        MockOSRMServer server(backend, config);
+        server.start();
+
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+
+        std::cout << "Mock OSRM server (" << backend->getName() << ") listening on "
+                  << server.getRouteUrl() << std::endl;
+
+        while (!stopRequested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+
+        server.stop();
+
+        MockServerStats stats = server.getStats();
+        std::cout << "Requests: " << stats.requests << " (route " << stats.routeRequests
+                  << ", table " << stats.tableRequests << "), injected errors: " << stats.injectedErrors
+                  << ", rejected: " << stats.rejected << ", bad requests: " << stats.badRequests
+                  << ", accept errors: " << stats.acceptErrors << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
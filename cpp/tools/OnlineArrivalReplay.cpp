@@ -0,0 +1,97 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include "RandomPointGenerator.h"
+#include "OnlineAssignment.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --people N           Arrivals (default 20000)\n"
+              << "  --centers N          Generated test centers (default 200)\n"
+              << "  --capacity N         Capacity per center (default 110)\n"
+              << "  --pwd-reserve F      Share of capacity held for PWD (default 0.1, adaptive)\n"
+              << "  --interval S         Seconds between background re-optimizations (default 0.05)\n"
+              << "  --engine NAME        Re-optimization engine: greedy, mcf, auction (default mcf)\n"
+              << "  --seed N             Random seed (default 42)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int peopleCount = 20000;
+    int centerCount = 200;
+    int capacity = 110;
+    double pwdReserve = 0.1;
+    double interval = 0.05;
+    AssignmentEngine engine = AssignmentEngine::MinCostFlow;
+    unsigned int seed = 42;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--people" && hasValue) peopleCount = std::stoi(argv[++i]);
+        else if (arg == "--centers" && hasValue) centerCount = std::stoi(argv[++i]);
+        else if (arg == "--capacity" && hasValue) capacity = std::stoi(argv[++i]);
+        else if (arg == "--pwd-reserve" && hasValue) pwdReserve = std::stod(argv[++i]);
+        else if (arg == "--interval" && hasValue) interval = std::stod(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (arg == "--engine" && hasValue) {
+            std::string name = argv[++i];
+            if (name == "greedy") engine = AssignmentEngine::Greedy;
+            else if (name == "mcf") engine = AssignmentEngine::MinCostFlow;
+            else if (name == "auction") engine = AssignmentEngine::Auction;
+            else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    try {
+        RandomPointGenerator rpg(seed);
+        std::vector<Point> people = rpg.generatePointsInRadius(40.7128, -74.0060, 10.0, peopleCount, "people");
+        std::vector<Point> testCenters = rpg.generateTestCenters(40.7128, -74.0060, 10.0, centerCount);
+
+        OnlineAssignmentService service(testCenters, std::vector<int>(testCenters.size(), capacity));
+        service.setPwdReservation(pwdReserve, true);
+        service.setReoptimization(engine);
+        service.startPeriodicReoptimization(interval);
+
+        // Arrivals in generation order while re-optimization runs in the background
+        auto start = std::chrono::steady_clock::now();
+        int rejected = 0;
+        for (const Point& person : people) {
+            if (service.assign(person).centerIndex == -1) rejected++;
+        }
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        service.stopPeriodicReoptimization();
+        int finalMoves = service.reoptimize();
+
+        double total = 0.0;
+        for (int personId = 0; personId < static_cast<int>(people.size()); personId++) {
+            total += service.getAssignedDistance(personId);
+        }
+
+        std::cout << people.size() << " arrivals in " << std::fixed << std::setprecision(1) << elapsedMs
+                  << " ms, " << rejected << " rejected, " << finalMoves << " moved by the final re-optimization, "
+                  << total << " km total" << std::endl;
+        for (const auto& stat : service.getServiceStats()) {
+            std::cout << "  " << std::left << std::setw(24) << stat.first << std::right
+                      << std::setprecision(2) << stat.second << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include "RandomPointGenerator.h"
+#include "ScenarioRunner.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --people N           Generated people (default 5000)\n"
+              << "  --centers N          Generated test centers (default 100)\n"
+              << "  --capacity N         Capacity per center (default 60)\n"
+              << "  --threads N          Scenarios run at once (default 0 = hardware concurrency)\n"
+              << "  --seed N             Random seed (default 42)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int peopleCount = 5000;
+    int centerCount = 100;
+    int capacity = 60;
+    int threads = 0;
+    unsigned int seed = 42;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--people" && hasValue) peopleCount = std::stoi(argv[++i]);
+        else if (arg == "--centers" && hasValue) centerCount = std::stoi(argv[++i]);
+        else if (arg == "--capacity" && hasValue) capacity = std::stoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) threads = std::stoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    try {
+        RandomPointGenerator rpg(seed);
+        std::vector<Point> people = rpg.generatePointsInRadius(40.7128, -74.0060, 10.0, peopleCount, "people");
+        std::vector<Point> testCenters = rpg.generateTestCenters(40.7128, -74.0060, 10.0, centerCount);
+
+        // One straight-line matrix shared by every scenario
+        AssignmentAlgorithm prepare;
+        DistanceMatrix matrix = prepare.prepareDistanceMatrix(people, testCenters);
+
+        std::vector<AssignmentScenario> scenarios = {
+            AssignmentScenario("greedy", capacity, AssignmentEngine::Greedy),
+            AssignmentScenario("min-cost-flow", capacity, AssignmentEngine::MinCostFlow),
+            AssignmentScenario("auction", capacity, AssignmentEngine::Auction),
+            AssignmentScenario("greedy-tight", capacity * 3 / 4, AssignmentEngine::Greedy),
+            AssignmentScenario("min-cost-flow-tight", capacity * 3 / 4, AssignmentEngine::MinCostFlow)
+        };
+
+        ScenarioRunner runner(people, testCenters, matrix);
+        runner.setThreadCount(threads);
+        std::vector<ScenarioResult> results = runner.run(scenarios);
+
+        std::cout << "\n" << people.size() << " people, " << testCenters.size() << " centers\n"
+                  << ScenarioRunner::formatTable(results);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}